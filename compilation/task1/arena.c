@@ -0,0 +1,114 @@
+#include "arena.h"
+#include "dynarray.h"
+#include <string.h>
+
+struct arena_block {
+    struct arena_block* next;
+    size_t size;
+    size_t used;
+    char* data;
+};
+
+struct arena {
+    struct arena_block* first;
+    struct arena_block* current;
+    char* ptr;
+    char* end;
+    char* last;
+    size_t block_size;
+};
+
+static size_t align_up(size_t n) {
+    return (n + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static struct arena_block* new_block(size_t size) {
+    /* The header and the data are one allocation, the data starts at an aligned offset */
+    struct arena_block* block = (struct arena_block*)ecmalloc(align_up(sizeof(struct arena_block)) + size);
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    block->data = (char*)block + align_up(sizeof(struct arena_block));
+    return block;
+}
+
+static void enter_block(Arena* arena, struct arena_block* block) {
+    arena->current = block;
+    arena->ptr = block->data;
+    arena->end = block->data + block->size;
+}
+
+Arena* arena_create(size_t block_size) {
+    Arena* arena = (Arena*)ecmalloc(sizeof(Arena));
+    arena->block_size = align_up(block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE);
+    arena->first = new_block(arena->block_size);
+    arena->last = NULL;
+    enter_block(arena, arena->first);
+    return arena;
+}
+
+/* Moves to the next block that can hold n bytes, creating it if needed */
+static void next_block(Arena* arena, size_t n) {
+    arena->current->used = (size_t)(arena->ptr - arena->current->data);
+
+    struct arena_block* block = arena->current->next;
+    while (block != NULL && block->size < n) {
+        /* Too small for this allocation: skip it, it will be used after the next reset */
+        block->used = 0;
+        arena->current = block;
+        block = block->next;
+    }
+
+    if (block == NULL) {
+        block = new_block(n > arena->block_size ? align_up(n) : arena->block_size);
+        block->next = arena->current->next;
+        arena->current->next = block;
+    }
+    enter_block(arena, block);
+}
+
+void* arena_alloc(Arena* arena, size_t n) {
+    n = align_up(n > 0 ? n : 1);
+    if ((size_t)(arena->end - arena->ptr) < n)
+        next_block(arena, n);
+
+    arena->last = arena->ptr;
+    arena->ptr += n;
+    return arena->last;
+}
+
+void* arena_grow(Arena* arena, void* p, size_t old_size, size_t new_size) {
+    if (p == NULL)
+        return arena_alloc(arena, new_size);
+
+    if (p == arena->last && (size_t)(arena->end - arena->last) >= align_up(new_size)) {
+        arena->ptr = arena->last + align_up(new_size > 0 ? new_size : 1);
+        return p;
+    }
+
+    void* q = arena_alloc(arena, new_size);
+    memcpy(q, p, old_size < new_size ? old_size : new_size);
+    return q;
+}
+
+void arena_reset(Arena* arena) {
+    arena->last = NULL;
+    enter_block(arena, arena->first);
+}
+
+size_t arena_used(const Arena* arena) {
+    size_t used = 0;
+    for (const struct arena_block* block = arena->first; block != arena->current; block = block->next)
+        used += block->used;
+    return used + (size_t)(arena->ptr - arena->current->data);
+}
+
+void arena_destroy(Arena* arena) {
+    struct arena_block* block = arena->first;
+    while (block != NULL) {
+        struct arena_block* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
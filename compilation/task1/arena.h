@@ -0,0 +1,38 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Arena (region) allocator.
+ * Memory is cut from big blocks by moving a pointer; single allocations are never freed.
+ * arena_reset releases everything allocated from the arena at once in O(1): the blocks are kept
+ * and reused by the next allocations. arena_destroy returns the blocks to the system.
+ *
+ * arena_grow resizes an allocation. If it is the last allocation made from the arena and the block
+ * has room, it grows in place; otherwise the data is copied to a new place.
+ *
+ * All allocations are aligned to ARENA_ALIGNMENT bytes.
+ */
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_DEFAULT_BLOCK_SIZE ((size_t)64 * 1024)
+
+typedef struct arena Arena;
+
+Arena* arena_create(size_t block_size);
+void* arena_alloc(Arena* arena, size_t n);
+void* arena_grow(Arena* arena, void* p, size_t old_size, size_t new_size);
+void arena_reset(Arena* arena);
+size_t arena_used(const Arena* arena);
+void arena_destroy(Arena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Many small short-lived arrays: malloc/free for every array against one arena reset per request.
+ * Usage: bench_arena [requests, default 2000] [arrays per request, default 1000]
+ */
+
+#include "dynarray.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define ELEMENTS_PER_ARRAY 24
+
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    int requests = argc > 1 ? atoi(argv[1]) : 2000;
+    int arrays = argc > 2 ? atoi(argv[2]) : 1000;
+    long long checksum = 0;
+
+    Dynarray* list = (Dynarray*)ecmalloc((size_t)arrays * sizeof(Dynarray));
+
+    double start = now_ms();
+    for (int r = 0; r < requests; ++r) {
+        for (int k = 0; k < arrays; ++k) {
+            init(&list[k], 0);
+            for (int i = 0; i < ELEMENTS_PER_ARRAY; ++i)
+                push_back(&list[k], r + k + i);
+        }
+        for (int k = 0; k < arrays; ++k) {
+            checksum += get(&list[k], ELEMENTS_PER_ARRAY - 1);
+            destroy(&list[k]);
+        }
+    }
+    double malloc_ms = now_ms() - start;
+
+    Arena* arena = arena_create(0);
+    start = now_ms();
+    for (int r = 0; r < requests; ++r) {
+        for (int k = 0; k < arrays; ++k) {
+            init_arena(&list[k], 0, arena);
+            for (int i = 0; i < ELEMENTS_PER_ARRAY; ++i)
+                push_back(&list[k], r + k + i);
+        }
+        for (int k = 0; k < arrays; ++k)
+            checksum -= get(&list[k], ELEMENTS_PER_ARRAY - 1);
+        arena_reset(arena);
+    }
+    double arena_ms = now_ms() - start;
+    arena_destroy(arena);
+    free(list);
+
+    printf("malloc/free: %8.1f ms\n", malloc_ms);
+    printf("arena:       %8.1f ms (%.2fx)\n", arena_ms, malloc_ms / arena_ms);
+    return checksum != 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Bitset against flags stored as int in Dynarray.
+ * Usage: bench_bitset [number of flags, default 50000000]
+ */
+
+#include "bitset.h"
+#include "dynarray.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static unsigned long long state = 88172645463325252ull;
+
+static unsigned next_random(void) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (unsigned)state;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 50000000;
+    size_t checksum = 0;
+
+    Bitset a, b;
+    Dynarray flags_a, flags_b;
+    bitset_init(&a, n);
+    bitset_init(&b, n);
+    init(&flags_a, n);
+    init(&flags_b, n);
+    for (size_t i = 0; i < n; ++i) {
+        int x = next_random() % 3 == 0;
+        int y = next_random() % 2 == 0;
+        bitset_set(&a, i, x);
+        bitset_set(&b, i, y);
+        flags_a.data[i] = x;
+        flags_b.data[i] = y;
+    }
+
+    printf("%zu flags: bitset %zu MB, Dynarray %zu MB\n\n", n, n / 8 >> 20, n * sizeof(int) >> 20);
+
+    double start = now_ms();
+    for (size_t i = 0; i < n; ++i)
+        flags_a.data[i] &= flags_b.data[i];
+    double and_dynarray = now_ms() - start;
+
+    start = now_ms();
+    bitset_and(&a, &b);
+    double and_bitset = now_ms() - start;
+
+    start = now_ms();
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+        count += flags_a.data[i] != 0;
+    double count_dynarray = now_ms() - start;
+
+    start = now_ms();
+    checksum += bitset_count(&a) - count;
+    double count_bitset = now_ms() - start;
+
+    start = now_ms();
+    for (size_t i = 0; i < n; ++i)
+        if (flags_a.data[i])
+            checksum += i;
+    double scan_dynarray = now_ms() - start;
+
+    start = now_ms();
+    for (size_t i = bitset_find_next(&a, 0); i < a.size; i = bitset_find_next(&a, i + 1))
+        checksum -= i;
+    double scan_bitset = now_ms() - start;
+
+    printf("%-24s %10s %10s\n", "", "Dynarray", "Bitset");
+    printf("%-24s %7.1f ms %7.1f ms\n", "and", and_dynarray, and_bitset);
+    printf("%-24s %7.1f ms %7.1f ms\n", "count", count_dynarray, count_bitset);
+    printf("%-24s %7.1f ms %7.1f ms\n", "iterate over set bits", scan_dynarray, scan_bitset);
+
+    start = now_ms();
+    bitset_build_rank(&a);
+    double build = now_ms() - start;
+
+    const size_t queries = 10000000;
+    start = now_ms();
+    for (size_t q = 0; q < queries; ++q)
+        checksum += bitset_rank(&a, n > 0 ? next_random() % n : 0);
+    double rank = now_ms() - start;
+
+    start = now_ms();
+    for (size_t q = 0; q < queries; ++q)
+        checksum += count > 0 ? bitset_select(&a, next_random() % count) : 0;
+    double select = now_ms() - start;
+
+    printf("\nrank index built in %.1f ms\n", build);
+    printf("rank:   %.1f ns per query\n", rank * 1e6 / queries);
+    printf("select: %.1f ns per query\n", select * 1e6 / queries);
+
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+    destroy(&flags_a);
+    destroy(&flags_b);
+    return checksum == 0 ? 2 : 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Several threads append to one shared array: Dynarray under a mutex against CDynarray.
+ * Usage: bench_cdynarray [elements in total, default 20000000]
+ */
+
+#include "cdynarray.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct job {
+    size_t count;
+    int first;
+    Dynarray* shared;
+    pthread_mutex_t* mutex;
+    CDynarray* concurrent;
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void* mutex_writer(void* arg) {
+    struct job* job = (struct job*)arg;
+    for (size_t i = 0; i < job->count; ++i) {
+        pthread_mutex_lock(job->mutex);
+        push_back(job->shared, job->first + (int)i);
+        pthread_mutex_unlock(job->mutex);
+    }
+    return NULL;
+}
+
+static void* concurrent_writer(void* arg) {
+    struct job* job = (struct job*)arg;
+    for (size_t i = 0; i < job->count; ++i)
+        cdyn_push_back(job->concurrent, job->first + (int)i);
+    return NULL;
+}
+
+static double run(int threads, size_t total, void* (*writer)(void*), Dynarray* shared, pthread_mutex_t* mutex,
+                  CDynarray* concurrent) {
+    pthread_t ids[64];
+    struct job jobs[64];
+
+    double start = now_ms();
+    for (int t = 0; t < threads; ++t) {
+        jobs[t].count = total / threads;
+        jobs[t].first = (int)(t * (total / threads));
+        jobs[t].shared = shared;
+        jobs[t].mutex = mutex;
+        jobs[t].concurrent = concurrent;
+        pthread_create(&ids[t], NULL, writer, &jobs[t]);
+    }
+    for (int t = 0; t < threads; ++t)
+        pthread_join(ids[t], NULL);
+    return now_ms() - start;
+}
+
+int main(int argc, char** argv) {
+    size_t total = argc > 1 ? strtoull(argv[1], NULL, 10) : 20000000;
+    int thread_counts[] = {1, 2, 4, 8, 16};
+
+    printf("threads   mutex+push_back   cdyn_push_back\n");
+    for (size_t c = 0; c < sizeof(thread_counts) / sizeof(thread_counts[0]); ++c) {
+        int threads = thread_counts[c];
+
+        Dynarray shared;
+        pthread_mutex_t mutex;
+        init(&shared, 0);
+        pthread_mutex_init(&mutex, NULL);
+        double mutex_ms = run(threads, total, mutex_writer, &shared, &mutex, NULL);
+        pthread_mutex_destroy(&mutex);
+
+        CDynarray concurrent;
+        cdyn_init(&concurrent);
+        double concurrent_ms = run(threads, total, concurrent_writer, NULL, NULL, &concurrent);
+
+        Dynarray snapshot;
+        init(&snapshot, 0);
+        cdyn_snapshot(&concurrent, &snapshot);
+        if (snapshot.size != shared.size) {
+            fprintf(stderr, "Size mismatch: %zu and %zu\n", snapshot.size, shared.size);
+            return 1;
+        }
+
+        printf("%7d %14.1f ms %14.1f ms\n", threads, mutex_ms, concurrent_ms);
+        destroy(&snapshot);
+        destroy(&shared);
+        cdyn_destroy(&concurrent);
+    }
+    return 0;
+}
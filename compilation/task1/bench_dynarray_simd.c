@@ -0,0 +1,90 @@
+/*
+ * Bulk operations of dynarray_simd against plain loops over Dynarray.
+ * Usage: bench_dynarray_simd [number of elements, default 10000000]
+ */
+
+#include "dynarray.h"
+#include "dynarray_simd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    const int repeats = 10;
+
+    Dynarray a;
+    init(&a, n);
+    for (size_t i = 0; i < n; ++i)
+        a.data[i] = (int)(i * 2654435761u % 1000);
+
+    volatile int64_t sink = 0;
+    double start, plain, simd;
+
+    printf("%-16s %10s %10s\n", "", "loop", "simd");
+
+    start = now_ms();
+    for (int r = 0; r < repeats; ++r) {
+        int64_t s = 0;
+        for (size_t i = 0; i < a.size; ++i)
+            s += a.data[i];
+        sink = sink + s;
+    }
+    plain = now_ms() - start;
+    start = now_ms();
+    for (int r = 0; r < repeats; ++r)
+        sink = sink + dyn_sum(&a);
+    simd = now_ms() - start;
+    printf("%-16s %7.2f ms %7.2f ms\n", "sum", plain / repeats, simd / repeats);
+
+    start = now_ms();
+    for (int r = 0; r < repeats; ++r) {
+        size_t c = 0;
+        for (size_t i = 0; i < a.size; ++i)
+            c += a.data[i] == 7;
+        sink = sink + (int64_t)c;
+    }
+    plain = now_ms() - start;
+    start = now_ms();
+    for (int r = 0; r < repeats; ++r)
+        sink = sink + (int64_t)dyn_count(&a, 7);
+    simd = now_ms() - start;
+    printf("%-16s %7.2f ms %7.2f ms\n", "count", plain / repeats, simd / repeats);
+
+    if (n > 0) {
+        start = now_ms();
+        for (int r = 0; r < repeats; ++r) {
+            size_t m = 0;
+            for (size_t i = 1; i < a.size; ++i)
+                if (a.data[i] < a.data[m])
+                    m = i;
+            sink = sink + (int64_t)m;
+        }
+        plain = now_ms() - start;
+        start = now_ms();
+        for (int r = 0; r < repeats; ++r)
+            sink = sink + (int64_t)dyn_argmin(&a);
+        simd = now_ms() - start;
+        printf("%-16s %7.2f ms %7.2f ms\n", "argmin", plain / repeats, simd / repeats);
+    }
+
+    start = now_ms();
+    for (int r = 0; r < repeats; ++r)
+        for (size_t i = 0; i < a.size; ++i)
+            a.data[i] = (int)((unsigned)a.data[i] * 3u);
+    plain = now_ms() - start;
+    start = now_ms();
+    for (int r = 0; r < repeats; ++r)
+        dyn_mul_scalar(&a, 3);
+    simd = now_ms() - start;
+    printf("%-16s %7.2f ms %7.2f ms\n", "mul_scalar", plain / repeats, simd / repeats);
+
+    destroy(&a);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Сравнение GDynarray и std::vector<int>
+// Запуск: bench_gdynarray [количество элементов, по умолчанию 10000000] [множитель для огромного массива]
+// Замер огромного массива (n * множитель элементов) выполняется, только если множитель задан,
+// например bench_gdynarray 10000000 50 - массив на 2 ГБ, std::vector при росте займёт около 6 ГБ.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "gdynarray.h"
+
+static volatile long long sink = 0;
+
+template <typename F>
+static double measure(F f) {
+    double best = 1e100;
+    for (int k = 0; k < 5; ++k) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+static void report(const char* name, double gdyn_ms, double vector_ms) {
+    std::printf("%-28s %10.2f ms %10.2f ms %8.2fx\n", name, gdyn_ms, vector_ms, vector_ms / gdyn_ms);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t huge_factor = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+    const size_t block = 1000;
+    const size_t small_n = 20000;
+
+    std::vector<int> source(block);
+    for (size_t i = 0; i < block; ++i)
+        source[i] = (int)i;
+
+    std::printf("%-28s %13s %13s %9s\n", "", "GDynarray", "std::vector", "speedup");
+
+    report("push_back",
+        measure([&] {
+            GDynarray a;
+            gdyn_init(&a, sizeof(int), 0);
+            for (size_t i = 0; i < n; ++i) {
+                int x = (int)i;
+                gdyn_push_back(&a, &x);
+            }
+            sink = sink + GDYN_AT(&a, int, n - 1);
+            gdyn_destroy(&a);
+        }),
+        measure([&] {
+            std::vector<int> v;
+            for (size_t i = 0; i < n; ++i)
+                v.push_back((int)i);
+            sink = sink + v[n - 1];
+        }));
+
+    report("append_n (blocks of 1000)",
+        measure([&] {
+            GDynarray a;
+            gdyn_init(&a, sizeof(int), 0);
+            for (size_t i = 0; i < n; i += block)
+                gdyn_append_n(&a, source.data(), block);
+            sink = sink + GDYN_AT(&a, int, 0);
+            gdyn_destroy(&a);
+        }),
+        measure([&] {
+            std::vector<int> v;
+            for (size_t i = 0; i < n; i += block)
+                v.insert(v.end(), source.begin(), source.end());
+            sink = sink + v[0];
+        }));
+
+    report("resize",
+        measure([&] {
+            GDynarray a;
+            gdyn_init(&a, sizeof(int), 0);
+            gdyn_resize(&a, n);
+            GDYN_AT(&a, int, n - 1) = 1;
+            sink = sink + GDYN_AT(&a, int, n - 1);
+            gdyn_destroy(&a);
+        }),
+        measure([&] {
+            std::vector<int> v;
+            v.resize(n);
+            v[n - 1] = 1;
+            sink = sink + v[n - 1];
+        }));
+
+    report("insert at front",
+        measure([&] {
+            GDynarray a;
+            gdyn_init(&a, sizeof(int), 0);
+            for (size_t i = 0; i < small_n; ++i) {
+                int x = (int)i;
+                gdyn_insert(&a, 0, &x, 1);
+            }
+            sink = sink + GDYN_AT(&a, int, 0);
+            gdyn_destroy(&a);
+        }),
+        measure([&] {
+            std::vector<int> v;
+            for (size_t i = 0; i < small_n; ++i)
+                v.insert(v.begin(), (int)i);
+            sink = sink + v[0];
+        }));
+
+    report("erase from front",
+        measure([&] {
+            GDynarray a;
+            gdyn_init(&a, sizeof(int), small_n);
+            while (a.size > 0)
+                gdyn_erase(&a, 0, 1);
+            gdyn_destroy(&a);
+        }),
+        measure([&] {
+            std::vector<int> v(small_n);
+            while (!v.empty())
+                v.erase(v.begin());
+        }));
+
+    // Огромный массив: GDynarray переходит на mremap, вектору приходится копировать при каждом росте
+    if (huge_factor == 0)
+        return 0;
+    size_t huge_n = n * huge_factor;
+    report("push_back (huge array)",
+        measure([&] {
+            GDynarray a;
+            gdyn_init(&a, sizeof(int), 0);
+            for (size_t i = 0; i < huge_n; i += block)
+                gdyn_append_n(&a, source.data(), block);
+            sink = sink + GDYN_AT(&a, int, 0);
+            gdyn_destroy(&a);
+        }),
+        measure([&] {
+            std::vector<int> v;
+            for (size_t i = 0; i < huge_n; i += block)
+                v.insert(v.end(), source.begin(), source.end());
+            sink = sink + v[0];
+        }));
+
+    return 0;
+}
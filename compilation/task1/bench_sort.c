@@ -0,0 +1,53 @@
+/*
+ * dyn_radix_sort against qsort on random keys.
+ * Usage: bench_sort [number of elements, default 10000000]
+ * Build with -fopenmp to get the parallel radix sort on large arrays.
+ */
+
+#include "dynarray.h"
+#include "dynarray_sort.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+
+    Dynarray keys, copy;
+    init(&keys, n);
+    init(&copy, n);
+    unsigned state = 12345;
+    for (size_t i = 0; i < n; ++i) {
+        state = state * 1103515245u + 12345u;
+        keys.data[i] = (int)(state ^ (state >> 16));
+    }
+
+    memcpy(copy.data, keys.data, n * sizeof(int));
+    double start = now_ms();
+    qsort(copy.data, n, sizeof(int), compare_ints);
+    double qsort_ms = now_ms() - start;
+
+    start = now_ms();
+    dyn_radix_sort(&keys);
+    double radix_ms = now_ms() - start;
+
+    int same = n == 0 || memcmp(keys.data, copy.data, n * sizeof(int)) == 0;
+    printf("qsort: %.2f ms, radix sort: %.2f ms, results %s\n", qsort_ms, radix_ms,
+           same ? "match" : "DIFFER");
+
+    destroy(&keys);
+    destroy(&copy);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,286 @@
+#include "bitset.h"
+#include "dynarray.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITSET_HAS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+static size_t word_count(size_t bits) {
+    return (bits + 63) / 64;
+}
+
+/* Zeroes the bits past size in the last word */
+static void trim_tail(Bitset* bs) {
+    if (bs->size % 64 != 0)
+        bs->words[bs->size / 64] &= (1ull << (bs->size % 64)) - 1;
+}
+
+void bitset_init(Bitset* bs, size_t initial_size) {
+    bs->words = NULL;
+    bs->size = 0;
+    bs->capacity = 0;
+    bs->rank_index = NULL;
+    bs->rank_blocks = 0;
+    bitset_resize(bs, initial_size);
+}
+
+void bitset_reserve(Bitset* bs, size_t new_capacity) {
+    if (new_capacity <= bs->capacity)
+        return;
+
+    size_t old_words = word_count(bs->capacity);
+    size_t new_words = word_count(new_capacity);
+    bs->words = (uint64_t*)ecrealloc(bs->words, new_words * sizeof(uint64_t));
+    memset(bs->words + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
+    bs->capacity = new_words * 64;
+}
+
+void bitset_resize(Bitset* bs, size_t new_size) {
+    static const double growth_factor = 2;
+    if (new_size > bs->capacity) {
+        size_t new_capacity = (size_t)(growth_factor * bs->capacity);
+        bitset_reserve(bs, new_capacity < new_size ? new_size : new_capacity);
+    }
+
+    if (new_size < bs->size) {
+        /* Bits that are cut off must be zero if the bitset grows again */
+        size_t first = word_count(new_size);
+        memset(bs->words + first, 0, (word_count(bs->size) - first) * sizeof(uint64_t));
+        bs->size = new_size;
+        trim_tail(bs);
+    }
+    bs->size = new_size;
+}
+
+void bitset_push_back(Bitset* bs, int bit) {
+    bitset_resize(bs, bs->size + 1);
+    if (bit)
+        bs->words[(bs->size - 1) / 64] |= 1ull << ((bs->size - 1) % 64);
+}
+
+int bitset_get(const Bitset* bs, size_t index) {
+    assert(index < bs->size);
+    return (int)((bs->words[index / 64] >> (index % 64)) & 1);
+}
+
+void bitset_set(Bitset* bs, size_t index, int bit) {
+    assert(index < bs->size);
+    if (bit)
+        bs->words[index / 64] |= 1ull << (index % 64);
+    else
+        bs->words[index / 64] &= ~(1ull << (index % 64));
+}
+
+void bitset_fill(Bitset* bs, int bit) {
+    memset(bs->words, bit ? 0xff : 0, word_count(bs->size) * sizeof(uint64_t));
+    if (bit)
+        trim_tail(bs);
+}
+
+/* Number of words of src that take part in an operation with dst */
+static size_t common_words(const Bitset* dst, const Bitset* src) {
+    size_t a = word_count(dst->size);
+    size_t b = word_count(src->size);
+    return a < b ? a : b;
+}
+
+void bitset_and(Bitset* dst, const Bitset* src) {
+    size_t n = common_words(dst, src);
+    for (size_t i = 0; i < n; ++i)
+        dst->words[i] &= src->words[i];
+    memset(dst->words + n, 0, (word_count(dst->size) - n) * sizeof(uint64_t));
+}
+
+void bitset_or(Bitset* dst, const Bitset* src) {
+    size_t n = common_words(dst, src);
+    for (size_t i = 0; i < n; ++i)
+        dst->words[i] |= src->words[i];
+    trim_tail(dst);
+}
+
+void bitset_xor(Bitset* dst, const Bitset* src) {
+    size_t n = common_words(dst, src);
+    for (size_t i = 0; i < n; ++i)
+        dst->words[i] ^= src->words[i];
+    trim_tail(dst);
+}
+
+void bitset_andnot(Bitset* dst, const Bitset* src) {
+    size_t n = common_words(dst, src);
+    for (size_t i = 0; i < n; ++i)
+        dst->words[i] &= ~src->words[i];
+}
+
+/* Popcount kernels */
+
+static size_t popcount_word(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (size_t)((x * 0x0101010101010101ull) >> 56);
+}
+
+static size_t popcount_scalar(const uint64_t* words, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+        count += popcount_word(words[i]);
+    return count;
+}
+
+#ifdef BITSET_HAS_X86_SIMD
+
+__attribute__((target("popcnt")))
+static size_t popcount_popcnt(const uint64_t* words, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+        count += (size_t)__builtin_popcountll(words[i]);
+    return count;
+}
+
+/* Counts bits of every nibble with a shuffle lookup table, sums the bytes with sad */
+__attribute__((target("avx2")))
+static size_t popcount_avx2(const uint64_t* words, size_t n) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(words + i));
+        __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low_mask));
+        __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, total);
+    size_t count = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    for (; i < n; ++i)
+        count += (size_t)__builtin_popcountll(words[i]);
+    return count;
+}
+
+#endif
+
+typedef size_t (*popcount_function)(const uint64_t*, size_t);
+
+/* Chosen once; threads that choose at the same time store the same pointer */
+static size_t popcount_words(const uint64_t* words, size_t n) {
+    static _Atomic(popcount_function) selected = NULL;
+    popcount_function result = atomic_load_explicit(&selected, memory_order_relaxed);
+    if (result == NULL) {
+#ifdef BITSET_HAS_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+            result = popcount_avx2;
+        else if (__builtin_cpu_supports("popcnt"))
+            result = popcount_popcnt;
+        else
+#endif
+            result = popcount_scalar;
+        atomic_store_explicit(&selected, result, memory_order_relaxed);
+    }
+    return result(words, n);
+}
+
+size_t bitset_count(const Bitset* bs) {
+    return popcount_words(bs->words, word_count(bs->size));
+}
+
+static unsigned lowest_bit(uint64_t x) {
+    return (unsigned)__builtin_ctzll(x);
+}
+
+size_t bitset_find_next(const Bitset* bs, size_t from) {
+    if (from >= bs->size)
+        return bs->size;
+
+    size_t i = from / 64;
+    uint64_t word = bs->words[i] & (~0ull << (from % 64));
+    size_t n = word_count(bs->size);
+    while (word == 0) {
+        if (++i == n)
+            return bs->size;
+        word = bs->words[i];
+    }
+    return i * 64 + lowest_bit(word);
+}
+
+void bitset_build_rank(Bitset* bs) {
+    size_t n = word_count(bs->size);
+    bs->rank_blocks = n / BITSET_SUPERBLOCK_WORDS + 1;
+    bs->rank_index = (uint64_t*)ecrealloc(bs->rank_index, bs->rank_blocks * sizeof(uint64_t));
+
+    uint64_t total = 0;
+    for (size_t block = 0; block < bs->rank_blocks; ++block) {
+        bs->rank_index[block] = total;
+        size_t first = block * BITSET_SUPERBLOCK_WORDS;
+        size_t count = n - first < BITSET_SUPERBLOCK_WORDS ? n - first : BITSET_SUPERBLOCK_WORDS;
+        total += popcount_words(bs->words + first, count);
+    }
+}
+
+size_t bitset_rank(const Bitset* bs, size_t index) {
+    assert(bs->rank_index != NULL && index <= bs->size);
+    size_t word = index / 64;
+    size_t block = word / BITSET_SUPERBLOCK_WORDS;
+
+    size_t rank = (size_t)bs->rank_index[block];
+    for (size_t i = block * BITSET_SUPERBLOCK_WORDS; i < word; ++i)
+        rank += popcount_word(bs->words[i]);
+    if (index % 64 != 0)
+        rank += popcount_word(bs->words[word] & ((1ull << (index % 64)) - 1));
+    return rank;
+}
+
+size_t bitset_select(const Bitset* bs, size_t k) {
+    assert(bs->rank_index != NULL);
+
+    /* Last superblock that starts with at most k set bits before it */
+    size_t left = 0;
+    size_t right = bs->rank_blocks;
+    while (right - left > 1) {
+        size_t middle = left + (right - left) / 2;
+        if (bs->rank_index[middle] <= k)
+            left = middle;
+        else
+            right = middle;
+    }
+
+    size_t rest = k - (size_t)bs->rank_index[left];
+    size_t n = word_count(bs->size);
+    for (size_t i = left * BITSET_SUPERBLOCK_WORDS; i < n; ++i) {
+        uint64_t word = bs->words[i];
+        size_t count = popcount_word(word);
+        if (rest < count) {
+            while (rest-- > 0)
+                word &= word - 1;
+            return i * 64 + lowest_bit(word);
+        }
+        rest -= count;
+    }
+    return bs->size;
+}
+
+void bitset_print(const Bitset* bs) {
+    printf("bitset: ");
+    for (size_t i = 0; i < bs->size; ++i)
+        printf("%i", bitset_get(bs, i));
+    printf("\n");
+}
+
+void bitset_destroy(Bitset* bs) {
+    free(bs->words);
+    free(bs->rank_index);
+    bs->words = NULL;
+    bs->rank_index = NULL;
+    bs->size = 0;
+    bs->capacity = 0;
+    bs->rank_blocks = 0;
+}
@@ -0,0 +1,63 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dynamic bitset: one bit per flag, stored in 64-bit words. Grows like Dynarray (capacity doubles).
+ * Bits past size in the last word are always zero.
+ *
+ * bitset_and, bitset_or, bitset_xor, bitset_andnot change dst in place; bits of src past its
+ * size count as zeros. bitset_count uses AVX2 or the POPCNT instruction when the processor has them.
+ * bitset_find_next returns the index of the first set bit at position >= from, or size if there is none.
+ *
+ * Rank and select need an index built with bitset_build_rank (one count per 512 bits);
+ * any change of the bitset makes the index stale until it is built again.
+ * bitset_rank(i) - number of set bits before position i.
+ * bitset_select(k) - position of the set bit number k (from 0), or size if there are not that many.
+ */
+
+#define BITSET_SUPERBLOCK_WORDS 8
+
+struct bitset {
+    uint64_t* words;
+    size_t size;
+    size_t capacity;        /* in bits, multiple of 64 */
+    uint64_t* rank_index;   /* set bits before every superblock */
+    size_t rank_blocks;
+};
+typedef struct bitset Bitset;
+
+void bitset_init(Bitset* bs, size_t initial_size);
+void bitset_reserve(Bitset* bs, size_t new_capacity);
+void bitset_resize(Bitset* bs, size_t new_size);
+void bitset_push_back(Bitset* bs, int bit);
+int bitset_get(const Bitset* bs, size_t index);
+void bitset_set(Bitset* bs, size_t index, int bit);
+void bitset_fill(Bitset* bs, int bit);
+
+void bitset_and(Bitset* dst, const Bitset* src);
+void bitset_or(Bitset* dst, const Bitset* src);
+void bitset_xor(Bitset* dst, const Bitset* src);
+void bitset_andnot(Bitset* dst, const Bitset* src);
+
+size_t bitset_count(const Bitset* bs);
+size_t bitset_find_next(const Bitset* bs, size_t from);
+
+void bitset_build_rank(Bitset* bs);
+size_t bitset_rank(const Bitset* bs, size_t index);
+size_t bitset_select(const Bitset* bs, size_t k);
+
+void bitset_print(const Bitset* bs);
+void bitset_destroy(Bitset* bs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
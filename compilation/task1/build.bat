@@ -0,0 +1,25 @@
+@echo off
+
+gcc -O2 -c dynarray.c -o dynarray.o
+gcc -O2 -c arena.c -o arena.o
+gcc -O2 -c gdynarray.c -o gdynarray.o
+gcc -O2 -std=c11 -c dynarray_simd.c -o dynarray_simd.o
+gcc -O2 -fopenmp -c dynarray_sort.c -o dynarray_sort.o
+gcc -O2 -c segdynarray.c -o segdynarray.o
+gcc -O2 -std=c11 -c cdynarray.c -o cdynarray.o
+gcc -O2 -c mdynarray.c -o mdynarray.o
+gcc -O2 -c compressed_dynarray.c -o compressed_dynarray.o
+gcc -O2 -std=c11 -c sbodynarray.c -o sbodynarray.o
+gcc -O2 -std=c11 -c bitset.c -o bitset.o
+gcc -O2 -c main.c -o main.o
+
+gcc dynarray.o arena.o main.o -o program.exe
+
+g++ -O2 bench_gdynarray.cpp dynarray.o arena.o gdynarray.o -o bench_gdynarray.exe
+gcc -O2 bench_arena.c dynarray.o arena.o -o bench_arena.exe
+gcc -O2 -std=c11 bench_cdynarray.c cdynarray.o dynarray.o arena.o -pthread -o bench_cdynarray.exe
+gcc -O2 bench_dynarray_simd.c dynarray_simd.o dynarray.o arena.o -o bench_dynarray_simd.exe
+gcc -O2 -fopenmp bench_sort.c dynarray_sort.o dynarray.o arena.o -o bench_sort.exe
+gcc -O2 -std=c11 bench_bitset.c bitset.o dynarray.o arena.o -o bench_bitset.exe
+
+program.exe
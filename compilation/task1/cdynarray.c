@@ -0,0 +1,101 @@
+#include "cdynarray.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+static size_t chunk_size(size_t k) {
+    return CDYN_FIRST_CHUNK << k;
+}
+
+static size_t chunk_start(size_t k) {
+    return (CDYN_FIRST_CHUNK << k) - CDYN_FIRST_CHUNK;
+}
+
+static size_t chunk_of(size_t index) {
+    size_t v = index + CDYN_FIRST_CHUNK;
+    return sizeof(unsigned long long) * 8 - 1 - (size_t)__builtin_clzll(v) - CDYN_FIRST_CHUNK_BITS;
+}
+
+/* Returns chunk k, allocating and installing it if nobody has done it yet */
+static int* get_chunk(CDynarray* pd, size_t k) {
+    int* chunk = atomic_load_explicit(&pd->chunks[k], memory_order_acquire);
+    if (chunk != NULL)
+        return chunk;
+
+    int* fresh = (int*)ecmalloc(chunk_size(k) * sizeof(int));
+    int* expected = NULL;
+    if (atomic_compare_exchange_strong_explicit(&pd->chunks[k], &expected, fresh,
+                                                memory_order_acq_rel, memory_order_acquire))
+        return fresh;
+
+    free(fresh);
+    return expected;
+}
+
+void cdyn_init(CDynarray* pd) {
+    for (size_t k = 0; k < CDYN_MAX_CHUNKS; ++k)
+        atomic_init(&pd->chunks[k], NULL);
+    atomic_init(&pd->reserved, 0);
+    atomic_init(&pd->committed, 0);
+}
+
+void cdyn_push_back(CDynarray* pd, int x) {
+    size_t index = atomic_fetch_add_explicit(&pd->reserved, 1, memory_order_relaxed);
+    size_t k = chunk_of(index);
+    get_chunk(pd, k)[index - chunk_start(k)] = x;
+    atomic_fetch_add_explicit(&pd->committed, 1, memory_order_release);
+}
+
+void cdyn_append_n(CDynarray* pd, const int* values, size_t n) {
+    if (n == 0)
+        return;
+
+    size_t index = atomic_fetch_add_explicit(&pd->reserved, n, memory_order_relaxed);
+    size_t left = n;
+    while (left > 0) {
+        size_t k = chunk_of(index);
+        size_t offset = index - chunk_start(k);
+        size_t count = chunk_size(k) - offset;
+        if (count > left)
+            count = left;
+
+        memcpy(get_chunk(pd, k) + offset, values, count * sizeof(int));
+        values += count;
+        index += count;
+        left -= count;
+    }
+    atomic_fetch_add_explicit(&pd->committed, n, memory_order_release);
+}
+
+size_t cdyn_size(const CDynarray* pd) {
+    return atomic_load_explicit(&((CDynarray*)pd)->committed, memory_order_acquire);
+}
+
+int cdyn_get(const CDynarray* pd, size_t index) {
+    assert(index < cdyn_size(pd));
+    size_t k = chunk_of(index);
+    int* chunk = atomic_load_explicit(&((CDynarray*)pd)->chunks[k], memory_order_acquire);
+    return chunk[index - chunk_start(k)];
+}
+
+void cdyn_snapshot(CDynarray* pd, Dynarray* out) {
+    /* Writers must have finished: while they run, committed slots need not form a prefix */
+    size_t size = atomic_load_explicit(&pd->committed, memory_order_acquire);
+    assert(size == atomic_load_explicit(&pd->reserved, memory_order_relaxed));
+
+    reserve(out, size);
+    out->size = size;
+    for (size_t k = 0; chunk_start(k) < size; ++k) {
+        size_t count = size - chunk_start(k);
+        if (count > chunk_size(k))
+            count = chunk_size(k);
+        int* chunk = atomic_load_explicit(&pd->chunks[k], memory_order_acquire);
+        memcpy(out->data + chunk_start(k), chunk, count * sizeof(int));
+    }
+}
+
+void cdyn_destroy(CDynarray* pd) {
+    for (size_t k = 0; k < CDYN_MAX_CHUNKS; ++k)
+        free(atomic_load(&pd->chunks[k]));
+    cdyn_init(pd);
+}
@@ -0,0 +1,56 @@
+#ifndef CONCURRENT_DYNAMIC_ARRAY_H
+#define CONCURRENT_DYNAMIC_ARRAY_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "dynarray.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dynamic array of int that many threads can append to at the same time without a lock.
+ *
+ * A writer reserves slots with one atomic fetch-add on the reserved counter and writes into them.
+ * Slots live in chunks of sizes CDYN_FIRST_CHUNK, 2 * CDYN_FIRST_CHUNK, ... (like SegDynarray),
+ * so existing elements never move. The first writer that reaches a missing chunk allocates it
+ * and installs it with compare-and-swap; if another writer was faster, the extra chunk is freed.
+ * This is the only place where writers may wait for each other, and it happens once per chunk.
+ *
+ * cdyn_size, cdyn_get and cdyn_snapshot may only be called after all writers have finished
+ * (for example, after joining the threads or a barrier); then they see all appended elements.
+ * While appends are running, the committed counter is only a count of finished appends, not a prefix:
+ * a later slot may be written while an earlier one is still empty, or its chunk not allocated yet.
+ * cdyn_snapshot asserts that no append is in progress. The order of elements from different
+ * threads is not defined.
+ *
+ * reserved and committed are updated by every append, so each sits on its own cache line
+ * to keep them from sharing it with each other and with the chunk table.
+ */
+
+#define CDYN_FIRST_CHUNK_BITS 10
+#define CDYN_FIRST_CHUNK ((size_t)1 << CDYN_FIRST_CHUNK_BITS)
+#define CDYN_MAX_CHUNKS (sizeof(size_t) * 8 - CDYN_FIRST_CHUNK_BITS)
+#define CDYN_CACHE_LINE 64
+
+struct cdynarray {
+    _Atomic(int*) chunks[CDYN_MAX_CHUNKS];
+    _Alignas(CDYN_CACHE_LINE) atomic_size_t reserved;
+    _Alignas(CDYN_CACHE_LINE) atomic_size_t committed;
+};
+typedef struct cdynarray CDynarray;
+
+void cdyn_init(CDynarray* pd);
+void cdyn_push_back(CDynarray* pd, int x);
+void cdyn_append_n(CDynarray* pd, const int* values, size_t n);
+size_t cdyn_size(const CDynarray* pd);
+int cdyn_get(const CDynarray* pd, size_t index);
+void cdyn_snapshot(CDynarray* pd, Dynarray* out);
+void cdyn_destroy(CDynarray* pd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
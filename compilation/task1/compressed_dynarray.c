@@ -0,0 +1,255 @@
+#include "compressed_dynarray.h"
+#include <string.h>
+#include <assert.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define LANES 4
+#define LANE_LENGTH (COMPRESSED_BLOCK / LANES)
+
+static size_t block_length(size_t size, size_t block) {
+    size_t rest = size - block * COMPRESSED_BLOCK;
+    return rest < COMPRESSED_BLOCK ? rest : COMPRESSED_BLOCK;
+}
+
+static unsigned bit_width(uint32_t x) {
+    unsigned width = 0;
+    while (x != 0) {
+        width++;
+        x >>= 1;
+    }
+    return width;
+}
+
+/* Bit packing: value i of a block goes to lane i % 4 at position i / 4. Each lane takes width words. */
+
+static void pack_block(const uint32_t* deltas, unsigned width, uint32_t* words) {
+    memset(words, 0, (size_t)width * LANES * sizeof(uint32_t));
+    if (width == 0)
+        return;
+
+    for (size_t position = 0; position < LANE_LENGTH; ++position) {
+        size_t bit = position * width;
+        size_t word = bit / 32;
+        unsigned shift = bit % 32;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            uint32_t v = deltas[position * LANES + lane];
+            words[word * LANES + lane] |= v << shift;
+            if (shift + width > 32)
+                words[(word + 1) * LANES + lane] |= v >> (32 - shift);
+        }
+    }
+}
+
+static uint32_t unpack_one(const uint32_t* words, unsigned width, size_t i) {
+    if (width == 0)
+        return 0;
+
+    size_t lane = i % LANES;
+    size_t bit = i / LANES * width;
+    size_t word = bit / 32;
+    unsigned shift = bit % 32;
+    uint64_t v = words[word * LANES + lane] >> shift;
+    if (shift + width > 32)
+        v |= (uint64_t)words[(word + 1) * LANES + lane] << (32 - shift);
+    return (uint32_t)(v & ((1ull << width) - 1));
+}
+
+static void unpack_block(const uint32_t* words, unsigned width, int reference, int* out) {
+#ifdef __SSE2__
+    __m128i base = _mm_set1_epi32(reference);
+    if (width == 0) {
+        for (size_t position = 0; position < LANE_LENGTH; ++position)
+            _mm_storeu_si128((__m128i*)(out + position * LANES), base);
+        return;
+    }
+
+    __m128i mask = _mm_set1_epi32(width == 32 ? -1 : (int)((1u << width) - 1));
+    for (size_t position = 0; position < LANE_LENGTH; ++position) {
+        size_t bit = position * width;
+        size_t word = bit / 32;
+        unsigned shift = bit % 32;
+        __m128i v = _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(words + word * LANES)), _mm_cvtsi32_si128((int)shift));
+        if (shift + width > 32) {
+            __m128i high = _mm_loadu_si128((const __m128i*)(words + (word + 1) * LANES));
+            v = _mm_or_si128(v, _mm_sll_epi32(high, _mm_cvtsi32_si128((int)(32 - shift))));
+        }
+        _mm_storeu_si128((__m128i*)(out + position * LANES), _mm_add_epi32(_mm_and_si128(v, mask), base));
+    }
+#else
+    for (size_t i = 0; i < COMPRESSED_BLOCK; ++i)
+        out[i] = (int)((uint32_t)reference + unpack_one(words, width, i));
+#endif
+}
+
+void bp_encode(BpDynarray* pc, const Dynarray* pd) {
+    pc->size = pd->size;
+    pc->block_count = (pd->size + COMPRESSED_BLOCK - 1) / COMPRESSED_BLOCK;
+    pc->references = (int*)ecmalloc(pc->block_count * sizeof(int) + 1);
+    pc->widths = (uint8_t*)ecmalloc(pc->block_count + 1);
+    pc->offsets = (size_t*)ecmalloc((pc->block_count + 1) * sizeof(size_t));
+
+    /* First pass: references and widths, to know the total size */
+    size_t total = 0;
+    for (size_t block = 0; block < pc->block_count; ++block) {
+        const int* values = pd->data + block * COMPRESSED_BLOCK;
+        size_t length = block_length(pd->size, block);
+
+        int min = values[0];
+        int max = values[0];
+        for (size_t i = 1; i < length; ++i) {
+            if (values[i] < min)
+                min = values[i];
+            if (values[i] > max)
+                max = values[i];
+        }
+
+        pc->references[block] = min;
+        pc->widths[block] = (uint8_t)bit_width((uint32_t)max - (uint32_t)min);
+        pc->offsets[block] = total;
+        total += (size_t)pc->widths[block] * LANES;
+    }
+    pc->offsets[pc->block_count] = total;
+
+    /* One extra group of words so the SIMD unpacking may always read the next word */
+    pc->words = (uint32_t*)ecmalloc((total + LANES) * sizeof(uint32_t));
+    memset(pc->words + total, 0, LANES * sizeof(uint32_t));
+
+    uint32_t deltas[COMPRESSED_BLOCK];
+    for (size_t block = 0; block < pc->block_count; ++block) {
+        const int* values = pd->data + block * COMPRESSED_BLOCK;
+        size_t length = block_length(pd->size, block);
+        for (size_t i = 0; i < COMPRESSED_BLOCK; ++i)
+            deltas[i] = i < length ? (uint32_t)values[i] - (uint32_t)pc->references[block] : 0;
+        pack_block(deltas, pc->widths[block], pc->words + pc->offsets[block]);
+    }
+}
+
+size_t bp_decode_block(const BpDynarray* pc, size_t block, int* out) {
+    assert(block < pc->block_count);
+    size_t length = block_length(pc->size, block);
+    if (length == COMPRESSED_BLOCK) {
+        unpack_block(pc->words + pc->offsets[block], pc->widths[block], pc->references[block], out);
+    }
+    else {
+        int buffer[COMPRESSED_BLOCK];
+        unpack_block(pc->words + pc->offsets[block], pc->widths[block], pc->references[block], buffer);
+        memcpy(out, buffer, length * sizeof(int));
+    }
+    return length;
+}
+
+void bp_decode(const BpDynarray* pc, Dynarray* out) {
+    reserve(out, pc->size);
+    out->size = pc->size;
+    for (size_t block = 0; block < pc->block_count; ++block)
+        bp_decode_block(pc, block, out->data + block * COMPRESSED_BLOCK);
+}
+
+int bp_get(const BpDynarray* pc, size_t index) {
+    assert(index < pc->size);
+    size_t block = index / COMPRESSED_BLOCK;
+    uint32_t delta = unpack_one(pc->words + pc->offsets[block], pc->widths[block], index % COMPRESSED_BLOCK);
+    return (int)((uint32_t)pc->references[block] + delta);
+}
+
+size_t bp_memory_usage(const BpDynarray* pc) {
+    return pc->block_count * (sizeof(int) + 1 + sizeof(size_t)) + pc->offsets[pc->block_count] * sizeof(uint32_t);
+}
+
+void bp_destroy(BpDynarray* pc) {
+    free(pc->references);
+    free(pc->widths);
+    free(pc->offsets);
+    free(pc->words);
+    memset(pc, 0, sizeof(*pc));
+}
+
+/* Delta + varint */
+
+static uint32_t zigzag(int32_t x) {
+    return ((uint32_t)x << 1) ^ (uint32_t)(x >> 31);
+}
+
+static int32_t unzigzag(uint32_t x) {
+    return (int32_t)(x >> 1) ^ -(int32_t)(x & 1);
+}
+
+void vb_encode(VbDynarray* pc, const Dynarray* pd) {
+    pc->size = pd->size;
+    pc->block_count = (pd->size + COMPRESSED_BLOCK - 1) / COMPRESSED_BLOCK;
+    pc->firsts = (int*)ecmalloc(pc->block_count * sizeof(int) + 1);
+    pc->offsets = (size_t*)ecmalloc((pc->block_count + 1) * sizeof(size_t));
+
+    /* A varint of 32 bits takes at most 5 bytes; the buffer is shrunk at the end */
+    size_t capacity = pd->size * 5 + 1;
+    pc->bytes = (uint8_t*)ecmalloc(capacity);
+
+    size_t n = 0;
+    for (size_t block = 0; block < pc->block_count; ++block) {
+        const int* values = pd->data + block * COMPRESSED_BLOCK;
+        size_t length = block_length(pd->size, block);
+
+        pc->firsts[block] = values[0];
+        pc->offsets[block] = n;
+        for (size_t i = 1; i < length; ++i) {
+            uint32_t v = zigzag((int32_t)((uint32_t)values[i] - (uint32_t)values[i - 1]));
+            while (v >= 0x80) {
+                pc->bytes[n++] = (uint8_t)(v | 0x80);
+                v >>= 7;
+            }
+            pc->bytes[n++] = (uint8_t)v;
+        }
+    }
+    pc->offsets[pc->block_count] = n;
+    pc->bytes = (uint8_t*)ecrealloc(pc->bytes, n + 1);
+}
+
+size_t vb_decode_block(const VbDynarray* pc, size_t block, int* out) {
+    assert(block < pc->block_count);
+    size_t length = block_length(pc->size, block);
+    const uint8_t* p = pc->bytes + pc->offsets[block];
+
+    uint32_t value = (uint32_t)pc->firsts[block];
+    out[0] = (int)value;
+    for (size_t i = 1; i < length; ++i) {
+        uint32_t v = 0;
+        unsigned shift = 0;
+        while (*p & 0x80) {
+            v |= (uint32_t)(*p++ & 0x7f) << shift;
+            shift += 7;
+        }
+        v |= (uint32_t)*p++ << shift;
+
+        value += (uint32_t)unzigzag(v);
+        out[i] = (int)value;
+    }
+    return length;
+}
+
+void vb_decode(const VbDynarray* pc, Dynarray* out) {
+    reserve(out, pc->size);
+    out->size = pc->size;
+    for (size_t block = 0; block < pc->block_count; ++block)
+        vb_decode_block(pc, block, out->data + block * COMPRESSED_BLOCK);
+}
+
+int vb_get(const VbDynarray* pc, size_t index) {
+    assert(index < pc->size);
+    int buffer[COMPRESSED_BLOCK];
+    vb_decode_block(pc, index / COMPRESSED_BLOCK, buffer);
+    return buffer[index % COMPRESSED_BLOCK];
+}
+
+size_t vb_memory_usage(const VbDynarray* pc) {
+    return pc->block_count * (sizeof(int) + sizeof(size_t)) + pc->offsets[pc->block_count];
+}
+
+void vb_destroy(VbDynarray* pc) {
+    free(pc->firsts);
+    free(pc->offsets);
+    free(pc->bytes);
+    memset(pc, 0, sizeof(*pc));
+}
@@ -0,0 +1,68 @@
+#ifndef COMPRESSED_DYNAMIC_ARRAY_H
+#define COMPRESSED_DYNAMIC_ARRAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dynarray.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compressed read-only forms of Dynarray. Both split the array into blocks of COMPRESSED_BLOCK ints;
+ * a block can be decoded on its own, which gives sequential iteration (block after block)
+ * and random access that decodes at most one block.
+ *
+ * BpDynarray - frame of reference + bit packing. For every block the minimum is stored,
+ * and the differences from it are packed with as many bits as the largest difference needs.
+ * Good for ints from a small range. Values are laid out in 4 interleaved lanes, so with SSE2
+ * 4 values are unpacked at once. bp_get decodes a single value without decoding the block.
+ *
+ * VbDynarray - differences between neighbours (zigzag-coded, so decreasing sequences work too)
+ * written as varints, 7 bits per byte. Good for sorted arrays. The first value of every block
+ * is stored as is, so blocks are independent.
+ *
+ * The *_decode_block functions write up to COMPRESSED_BLOCK values to out and return their number.
+ */
+
+#define COMPRESSED_BLOCK 128
+
+struct bpdynarray {
+    size_t size;
+    size_t block_count;
+    int* references;
+    uint8_t* widths;
+    size_t* offsets;  /* first word of every block in words */
+    uint32_t* words;
+};
+typedef struct bpdynarray BpDynarray;
+
+void bp_encode(BpDynarray* pc, const Dynarray* pd);
+void bp_decode(const BpDynarray* pc, Dynarray* out);
+size_t bp_decode_block(const BpDynarray* pc, size_t block, int* out);
+int bp_get(const BpDynarray* pc, size_t index);
+size_t bp_memory_usage(const BpDynarray* pc);
+void bp_destroy(BpDynarray* pc);
+
+struct vbdynarray {
+    size_t size;
+    size_t block_count;
+    int* firsts;
+    size_t* offsets;  /* first byte of every block */
+    uint8_t* bytes;
+};
+typedef struct vbdynarray VbDynarray;
+
+void vb_encode(VbDynarray* pc, const Dynarray* pd);
+void vb_decode(const VbDynarray* pc, Dynarray* out);
+size_t vb_decode_block(const VbDynarray* pc, size_t block, int* out);
+int vb_get(const VbDynarray* pc, size_t index);
+size_t vb_memory_usage(const VbDynarray* pc);
+void vb_destroy(VbDynarray* pc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,4 +1,5 @@
 #include "dynarray.h"
+#include "arena.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -12,16 +13,32 @@ void* ecmalloc(size_t n) {
     return p;
 }
 
+void* ecrealloc(void* p, size_t n) {
+    void* q = realloc(p, n);
+    if (q == NULL) {
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(1);
+    }
+    return q;
+}
+
 void clear(Dynarray* pd) {
     for (size_t i = 0; i < pd->size; ++i)
         pd->data[i] = 0;
 }
 
 void init(Dynarray* pd, size_t initial_size) {
+    init_arena(pd, initial_size, NULL);
+}
+
+void init_arena(Dynarray* pd, size_t initial_size, struct arena* arena) {
     pd->size = initial_size;
     pd->capacity = initial_size;
+    pd->arena = arena;
     if (pd->size == 0)
         pd->data = NULL;
+    else if (arena != NULL)
+        pd->data = (int*)arena_alloc(arena, pd->capacity * sizeof(int));
     else
         pd->data = (int*)ecmalloc(pd->capacity * sizeof(int));
     clear(pd);
@@ -31,14 +48,10 @@ void reserve(Dynarray* pd, size_t new_capacity) {
     if (new_capacity <= pd->capacity)
         return;
 
-    int* new_data = (int*)ecmalloc(new_capacity * sizeof(int));
-
-    for (size_t i = 0; i < pd->size; ++i) {
-        new_data[i] = pd->data[i];
-    }
-
-    free(pd->data);
-    pd->data = new_data;
+    if (pd->arena != NULL)
+        pd->data = (int*)arena_grow(pd->arena, pd->data, pd->capacity * sizeof(int), new_capacity * sizeof(int));
+    else
+        pd->data = (int*)ecrealloc(pd->data, new_capacity * sizeof(int));
     pd->capacity = new_capacity;
 }
 
@@ -74,6 +87,8 @@ void print(const Dynarray* pd) {
 }
 
 void destroy(Dynarray* pd) {
-    free(pd->data);
+    /* Memory taken from an arena is released by arena_reset / arena_destroy */
+    if (pd->arena == NULL)
+        free(pd->data);
     pd->data = NULL;
 }
\ No newline at end of file
@@ -3,16 +3,25 @@
 
 #include <stdlib.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct arena;
+
 struct dynarray {
     int* data;
     size_t size;
     size_t capacity;
+    struct arena* arena; /* NULL - memory from malloc */
 };
 typedef struct dynarray Dynarray;
 
 void* ecmalloc(size_t n);
+void* ecrealloc(void* p, size_t n);
 void clear(Dynarray* pd);
 void init(Dynarray* pd, size_t initial_size);
+void init_arena(Dynarray* pd, size_t initial_size, struct arena* arena);
 void reserve(Dynarray* pd, size_t new_capacity);
 void push_back(Dynarray* pd, int x);
 int get(const Dynarray* pd, size_t index);
@@ -20,4 +29,8 @@ void set(Dynarray* pd, size_t index, int value);
 void print(const Dynarray* pd);
 void destroy(Dynarray* pd);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include "dynarray_simd.h"
+#include <assert.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DYN_HAS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+struct kernels {
+    int64_t (*sum)(const int* a, size_t n);
+    int (*min)(const int* a, size_t n);
+    int (*max)(const int* a, size_t n);
+    size_t (*count)(const int* a, size_t n, int value);
+    size_t (*find_first)(const int* a, size_t n, int value);
+    void (*fill)(int* a, size_t n, int value);
+    void (*add)(int* a, size_t n, int value);
+    void (*mul)(int* a, size_t n, int value);
+};
+
+/* Plain C versions. They also process the tails of the vector versions. */
+
+static int64_t sum_scalar(const int* a, size_t n) {
+    int64_t s = 0;
+    for (size_t i = 0; i < n; ++i)
+        s += a[i];
+    return s;
+}
+
+static int min_scalar(const int* a, size_t n) {
+    int m = a[0];
+    for (size_t i = 1; i < n; ++i)
+        if (a[i] < m)
+            m = a[i];
+    return m;
+}
+
+static int max_scalar(const int* a, size_t n) {
+    int m = a[0];
+    for (size_t i = 1; i < n; ++i)
+        if (a[i] > m)
+            m = a[i];
+    return m;
+}
+
+static size_t count_scalar(const int* a, size_t n, int value) {
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i)
+        c += a[i] == value;
+    return c;
+}
+
+static size_t find_first_scalar(const int* a, size_t n, int value) {
+    for (size_t i = 0; i < n; ++i)
+        if (a[i] == value)
+            return i;
+    return n;
+}
+
+static void fill_scalar(int* a, size_t n, int value) {
+    for (size_t i = 0; i < n; ++i)
+        a[i] = value;
+}
+
+static void add_scalar(int* a, size_t n, int value) {
+    for (size_t i = 0; i < n; ++i)
+        a[i] = (int)((unsigned)a[i] + (unsigned)value);
+}
+
+static void mul_scalar(int* a, size_t n, int value) {
+    for (size_t i = 0; i < n; ++i)
+        a[i] = (int)((unsigned)a[i] * (unsigned)value);
+}
+
+static const struct kernels scalar_kernels = {
+    sum_scalar, min_scalar, max_scalar, count_scalar, find_first_scalar, fill_scalar, add_scalar, mul_scalar
+};
+
+#ifdef DYN_HAS_X86_SIMD
+
+/* Lanes of the count accumulator are flushed every COUNT_BLOCK elements so they never overflow. */
+#define COUNT_BLOCK ((size_t)1 << 24)
+
+/* SSE4.1: 4 ints per register */
+
+__attribute__((target("sse4.1")))
+static int64_t sum_sse41(const int* a, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(a + i));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(v));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return lanes[0] + lanes[1] + sum_scalar(a + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+static int min_sse41(const int* a, size_t n) {
+    if (n < 4)
+        return min_scalar(a, n);
+    __m128i m = _mm_loadu_si128((const __m128i*)a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4)
+        m = _mm_min_epi32(m, _mm_loadu_si128((const __m128i*)(a + i)));
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, m);
+    int result = min_scalar(lanes, 4);
+    if (i < n) {
+        int tail = min_scalar(a + i, n - i);
+        if (tail < result)
+            result = tail;
+    }
+    return result;
+}
+
+__attribute__((target("sse4.1")))
+static int max_sse41(const int* a, size_t n) {
+    if (n < 4)
+        return max_scalar(a, n);
+    __m128i m = _mm_loadu_si128((const __m128i*)a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4)
+        m = _mm_max_epi32(m, _mm_loadu_si128((const __m128i*)(a + i)));
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, m);
+    int result = max_scalar(lanes, 4);
+    if (i < n) {
+        int tail = max_scalar(a + i, n - i);
+        if (tail > result)
+            result = tail;
+    }
+    return result;
+}
+
+__attribute__((target("sse4.1")))
+static size_t count_sse41(const int* a, size_t n, int value) {
+    __m128i needle = _mm_set1_epi32(value);
+    size_t c = 0;
+    size_t i = 0;
+    while (i + 4 <= n) {
+        size_t end = i + COUNT_BLOCK < n ? i + COUNT_BLOCK : n;
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 4 <= end; i += 4)
+            acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), needle));
+        unsigned lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, acc);
+        c += (size_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    return c + count_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("sse4.1")))
+static size_t find_first_sse41(const int* a, size_t n, int value) {
+    __m128i needle = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), needle)));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + find_first_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("sse4.1")))
+static void fill_sse41(int* a, size_t n, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i*)(a + i), v);
+    fill_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("sse4.1")))
+static void add_sse41(int* a, size_t n, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i*)(a + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(a + i)), v));
+    add_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("sse4.1")))
+static void mul_sse41(int* a, size_t n, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i*)(a + i), _mm_mullo_epi32(_mm_loadu_si128((const __m128i*)(a + i)), v));
+    mul_scalar(a + i, n - i, value);
+}
+
+static const struct kernels sse41_kernels = {
+    sum_sse41, min_sse41, max_sse41, count_sse41, find_first_sse41, fill_sse41, add_sse41, mul_sse41
+};
+
+/* AVX2: 8 ints per register */
+
+__attribute__((target("avx2")))
+static int64_t sum_avx2(const int* a, size_t n) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(a + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_scalar(a + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static int min_avx2(const int* a, size_t n) {
+    if (n < 8)
+        return min_scalar(a, n);
+    __m256i m = _mm256_loadu_si256((const __m256i*)a);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8)
+        m = _mm256_min_epi32(m, _mm256_loadu_si256((const __m256i*)(a + i)));
+    int lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, m);
+    int result = min_scalar(lanes, 8);
+    if (i < n) {
+        int tail = min_scalar(a + i, n - i);
+        if (tail < result)
+            result = tail;
+    }
+    return result;
+}
+
+__attribute__((target("avx2")))
+static int max_avx2(const int* a, size_t n) {
+    if (n < 8)
+        return max_scalar(a, n);
+    __m256i m = _mm256_loadu_si256((const __m256i*)a);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8)
+        m = _mm256_max_epi32(m, _mm256_loadu_si256((const __m256i*)(a + i)));
+    int lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, m);
+    int result = max_scalar(lanes, 8);
+    if (i < n) {
+        int tail = max_scalar(a + i, n - i);
+        if (tail > result)
+            result = tail;
+    }
+    return result;
+}
+
+__attribute__((target("avx2")))
+static size_t count_avx2(const int* a, size_t n, int value) {
+    __m256i needle = _mm256_set1_epi32(value);
+    size_t c = 0;
+    size_t i = 0;
+    while (i + 8 <= n) {
+        size_t end = i + COUNT_BLOCK < n ? i + COUNT_BLOCK : n;
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 8 <= end; i += 8)
+            acc = _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), needle));
+        unsigned lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, acc);
+        for (int k = 0; k < 8; ++k)
+            c += lanes[k];
+    }
+    return c + count_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static size_t find_first_avx2(const int* a, size_t n, int value) {
+    __m256i needle = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), needle);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + find_first_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static void fill_avx2(int* a, size_t n, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i*)(a + i), v);
+    fill_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static void add_avx2(int* a, size_t n, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), v));
+    add_scalar(a + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static void mul_avx2(int* a, size_t n, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), v));
+    mul_scalar(a + i, n - i, value);
+}
+
+static const struct kernels avx2_kernels = {
+    sum_avx2, min_avx2, max_avx2, count_avx2, find_first_avx2, fill_avx2, add_avx2, mul_avx2
+};
+
+#endif
+
+/*
+ * The choice is made once. Several threads may make it at the same time, but they all
+ * store the same pointer, and the atomic makes that race well-defined.
+ */
+static const struct kernels* select_kernels(void) {
+    static _Atomic(const struct kernels*) selected = NULL;
+    const struct kernels* result = atomic_load_explicit(&selected, memory_order_relaxed);
+    if (result == NULL) {
+#ifdef DYN_HAS_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            result = &avx2_kernels;
+        else if (__builtin_cpu_supports("sse4.1"))
+            result = &sse41_kernels;
+        else
+#endif
+            result = &scalar_kernels;
+        atomic_store_explicit(&selected, result, memory_order_relaxed);
+    }
+    return result;
+}
+
+int64_t dyn_sum(const Dynarray* pd) {
+    return select_kernels()->sum(pd->data, pd->size);
+}
+
+int dyn_min(const Dynarray* pd) {
+    assert(pd->size > 0);
+    return select_kernels()->min(pd->data, pd->size);
+}
+
+int dyn_max(const Dynarray* pd) {
+    assert(pd->size > 0);
+    return select_kernels()->max(pd->data, pd->size);
+}
+
+size_t dyn_argmin(const Dynarray* pd) {
+    return dyn_find_first(pd, dyn_min(pd));
+}
+
+size_t dyn_count(const Dynarray* pd, int value) {
+    return select_kernels()->count(pd->data, pd->size, value);
+}
+
+size_t dyn_find_first(const Dynarray* pd, int value) {
+    return select_kernels()->find_first(pd->data, pd->size, value);
+}
+
+void dyn_fill(Dynarray* pd, int value) {
+    select_kernels()->fill(pd->data, pd->size, value);
+}
+
+void dyn_add_scalar(Dynarray* pd, int value) {
+    select_kernels()->add(pd->data, pd->size, value);
+}
+
+void dyn_mul_scalar(Dynarray* pd, int value) {
+    select_kernels()->mul(pd->data, pd->size, value);
+}
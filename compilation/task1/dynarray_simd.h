@@ -0,0 +1,35 @@
+#ifndef DYNAMIC_ARRAY_SIMD_H
+#define DYNAMIC_ARRAY_SIMD_H
+
+#include "dynarray.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bulk operations over Dynarray.
+ * On x86 with GCC/Clang the best of AVX2, SSE4.1 or plain C is chosen at the first call,
+ * depending on what the processor supports. Elsewhere the plain C version is used.
+ *
+ * dyn_min, dyn_max and dyn_argmin require a non-empty array.
+ * dyn_find_first returns pd->size if the value is not found.
+ * dyn_add_scalar and dyn_mul_scalar wrap around on overflow.
+ */
+
+int64_t dyn_sum(const Dynarray* pd);
+int dyn_min(const Dynarray* pd);
+int dyn_max(const Dynarray* pd);
+size_t dyn_argmin(const Dynarray* pd);
+size_t dyn_count(const Dynarray* pd, int value);
+size_t dyn_find_first(const Dynarray* pd, int value);
+void dyn_fill(Dynarray* pd, int value);
+void dyn_add_scalar(Dynarray* pd, int value);
+void dyn_mul_scalar(Dynarray* pd, int value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
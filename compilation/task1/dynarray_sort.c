@@ -0,0 +1,244 @@
+#include "dynarray_sort.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_PASSES (32 / RADIX_BITS)
+
+static unsigned key_of(int x, int pass) {
+    return (((uint32_t)x ^ 0x80000000u) >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+}
+
+static void radix_sort_serial(int* data, int* buffer, size_t n) {
+    size_t counts[RADIX_PASSES][RADIX_SIZE];
+    memset(counts, 0, sizeof(counts));
+
+    /* One pass over the data for the histograms of all bytes */
+    for (size_t i = 0; i < n; ++i)
+        for (int pass = 0; pass < RADIX_PASSES; ++pass)
+            counts[pass][key_of(data[i], pass)] += 1;
+
+    int* from = data;
+    int* to = buffer;
+    for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+        /* All keys have the same byte - this pass would not change anything */
+        if (counts[pass][key_of(from[0], pass)] == n)
+            continue;
+
+        size_t offsets[RADIX_SIZE];
+        size_t sum = 0;
+        for (int b = 0; b < RADIX_SIZE; ++b) {
+            offsets[b] = sum;
+            sum += counts[pass][b];
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            to[offsets[key_of(from[i], pass)]++] = from[i];
+
+        int* t = from;
+        from = to;
+        to = t;
+    }
+
+    if (from != data)
+        memcpy(data, from, n * sizeof(int));
+}
+
+#ifdef _OPENMP
+/*
+ * Every thread takes a contiguous part of the array, counts its own histogram, and then
+ * scatters its part to offsets computed from the histograms of all threads.
+ * Threads write to disjoint places, and elements of each thread keep their order, so the sort stays stable.
+ */
+static void radix_sort_parallel(int* data, int* buffer, size_t n) {
+    int threads = omp_get_max_threads();
+    size_t (*counts)[RADIX_SIZE] = ecmalloc((size_t)threads * sizeof(*counts));
+
+    int* from = data;
+    int* to = buffer;
+    for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+        int skip = 0;
+
+        #pragma omp parallel num_threads(threads)
+        {
+            int t = omp_get_thread_num();
+            int count = omp_get_num_threads();
+            size_t begin = n * t / count;
+            size_t end = n * (t + 1) / count;
+
+            size_t* local = counts[t];
+            memset(local, 0, sizeof(counts[0]));
+            for (size_t i = begin; i < end; ++i)
+                local[key_of(from[i], pass)] += 1;
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                size_t sum = 0;
+                for (int b = 0; b < RADIX_SIZE; ++b) {
+                    size_t bucket = 0;
+                    for (int k = 0; k < count; ++k) {
+                        size_t c = counts[k][b];
+                        counts[k][b] = sum;
+                        sum += c;
+                        bucket += c;
+                    }
+                    if (bucket == n)
+                        skip = 1;
+                }
+            }
+
+            if (!skip)
+                for (size_t i = begin; i < end; ++i)
+                    to[local[key_of(from[i], pass)]++] = from[i];
+        }
+
+        if (!skip) {
+            int* t = from;
+            from = to;
+            to = t;
+        }
+    }
+
+    if (from != data)
+        memcpy(data, from, n * sizeof(int));
+    free(counts);
+}
+#endif
+
+void dyn_radix_sort(Dynarray* pd) {
+    if (pd->size < 2)
+        return;
+
+    int* buffer = ecmalloc(pd->size * sizeof(int));
+#ifdef _OPENMP
+    if (pd->size >= DYN_PARALLEL_SORT_THRESHOLD && omp_get_max_threads() > 1)
+        radix_sort_parallel(pd->data, buffer, pd->size);
+    else
+#endif
+        radix_sort_serial(pd->data, buffer, pd->size);
+    free(buffer);
+}
+
+size_t dyn_lower_bound(const Dynarray* pd, int value) {
+    size_t left = 0;
+    size_t right = pd->size;
+    while (left < right) {
+        size_t middle = left + (right - left) / 2;
+        if (pd->data[middle] < value)
+            left = middle + 1;
+        else
+            right = middle;
+    }
+    return left;
+}
+
+size_t dyn_binary_search(const Dynarray* pd, int value) {
+    size_t index = dyn_lower_bound(pd, value);
+    if (index < pd->size && pd->data[index] == value)
+        return index;
+    return pd->size;
+}
+
+size_t dyn_interpolation_search(const Dynarray* pd, int value) {
+    if (pd->size == 0)
+        return 0;
+
+    size_t left = 0;
+    size_t right = pd->size - 1;
+    while (left <= right && value >= pd->data[left] && value <= pd->data[right]) {
+        int64_t low = pd->data[left];
+        int64_t high = pd->data[right];
+        if (low == high)
+            return left;
+
+        size_t position = left + (size_t)((double)(right - left) * (double)(value - low) / (double)(high - low));
+        if (pd->data[position] == value)
+            return position;
+        if (pd->data[position] < value)
+            left = position + 1;
+        else
+            right = position - 1;
+    }
+    return pd->size;
+}
+
+void dyn_unique(Dynarray* pd) {
+    if (pd->size == 0)
+        return;
+
+    size_t last = 0;
+    for (size_t i = 1; i < pd->size; ++i)
+        if (pd->data[i] != pd->data[last])
+            pd->data[++last] = pd->data[i];
+    pd->size = last + 1;
+}
+
+/* Makes out an array of exactly size elements with unspecified contents */
+static void prepare_output(Dynarray* out, size_t size) {
+    reserve(out, size);
+    out->size = size;
+}
+
+void dyn_merge(const Dynarray* a, const Dynarray* b, Dynarray* out) {
+    assert(out != a && out != b);
+    prepare_output(out, a->size + b->size);
+
+    size_t i = 0, j = 0, k = 0;
+    while (i < a->size && j < b->size) {
+        if (b->data[j] < a->data[i])
+            out->data[k++] = b->data[j++];
+        else
+            out->data[k++] = a->data[i++];
+    }
+    while (i < a->size)
+        out->data[k++] = a->data[i++];
+    while (j < b->size)
+        out->data[k++] = b->data[j++];
+}
+
+void dyn_intersection(const Dynarray* a, const Dynarray* b, Dynarray* out) {
+    assert(out != a && out != b);
+    prepare_output(out, a->size < b->size ? a->size : b->size);
+
+    size_t i = 0, j = 0, k = 0;
+    while (i < a->size && j < b->size) {
+        if (a->data[i] < b->data[j])
+            i++;
+        else if (b->data[j] < a->data[i])
+            j++;
+        else {
+            out->data[k++] = a->data[i++];
+            j++;
+        }
+    }
+    out->size = k;
+}
+
+void dyn_union(const Dynarray* a, const Dynarray* b, Dynarray* out) {
+    assert(out != a && out != b);
+    prepare_output(out, a->size + b->size);
+
+    size_t i = 0, j = 0, k = 0;
+    while (i < a->size && j < b->size) {
+        if (a->data[i] < b->data[j])
+            out->data[k++] = a->data[i++];
+        else if (b->data[j] < a->data[i])
+            out->data[k++] = b->data[j++];
+        else {
+            out->data[k++] = a->data[i++];
+            j++;
+        }
+    }
+    while (i < a->size)
+        out->data[k++] = a->data[i++];
+    while (j < b->size)
+        out->data[k++] = b->data[j++];
+    out->size = k;
+}
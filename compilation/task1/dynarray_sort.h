@@ -0,0 +1,45 @@
+#ifndef DYNAMIC_ARRAY_SORT_H
+#define DYNAMIC_ARRAY_SORT_H
+
+#include "dynarray.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Sorting and operations on sorted Dynarray.
+ *
+ * dyn_radix_sort - stable LSD radix sort by bytes, signed keys are handled by flipping the sign bit.
+ *                  Arrays of at least DYN_PARALLEL_SORT_THRESHOLD elements are sorted with
+ *                  per-thread histograms when the program is compiled with OpenMP (-fopenmp).
+ *
+ * The rest of the functions expect arrays sorted in ascending order.
+ * dyn_lower_bound returns the index of the first element >= value (pd->size if there is none).
+ * dyn_binary_search and dyn_interpolation_search return the index of some element equal to value,
+ * or pd->size if there is no such element. Interpolation search is faster on evenly distributed keys.
+ * dyn_unique removes repeated elements in place.
+ * dyn_merge, dyn_intersection and dyn_union write the result to out (out must be initialized,
+ * its old contents are replaced). out must not be a or b: it is resized before the inputs are read.
+ * Repeated elements are treated like in std::set_union
+ * and std::set_intersection.
+ */
+
+#define DYN_PARALLEL_SORT_THRESHOLD ((size_t)1 << 20)
+
+void dyn_radix_sort(Dynarray* pd);
+
+size_t dyn_lower_bound(const Dynarray* pd, int value);
+size_t dyn_binary_search(const Dynarray* pd, int value);
+size_t dyn_interpolation_search(const Dynarray* pd, int value);
+void dyn_unique(Dynarray* pd);
+
+void dyn_merge(const Dynarray* a, const Dynarray* b, Dynarray* out);
+void dyn_intersection(const Dynarray* a, const Dynarray* b, Dynarray* out);
+void dyn_union(const Dynarray* a, const Dynarray* b, Dynarray* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
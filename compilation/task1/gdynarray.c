@@ -0,0 +1,192 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "gdynarray.h"
+#include "dynarray.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+void gdyn_init(GDynarray* pd, size_t elem_size, size_t initial_size) {
+    assert(elem_size > 0);
+    pd->data = NULL;
+    pd->size = 0;
+    pd->capacity = 0;
+    pd->elem_size = elem_size;
+    pd->mapped = 0;
+    gdyn_resize(pd, initial_size);
+    if (initial_size > 0)
+        memset(pd->data, 0, initial_size * elem_size);
+}
+
+#ifdef __linux__
+static void* map_block(size_t bytes) {
+    void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(1);
+    }
+    return p;
+}
+#endif
+
+/* Sets capacity to exactly new_capacity elements (new_capacity >= size). */
+static void set_capacity(GDynarray* pd, size_t new_capacity) {
+    size_t old_bytes = pd->capacity * pd->elem_size;
+    size_t new_bytes = new_capacity * pd->elem_size;
+    assert(new_capacity >= pd->size);
+    assert(new_capacity == 0 || new_bytes / new_capacity == pd->elem_size);
+
+    if (new_capacity == 0) {
+        gdyn_destroy(pd);
+        return;
+    }
+
+#ifdef __linux__
+    if (pd->mapped && new_bytes >= GDYN_MMAP_THRESHOLD) {
+        void* p = mremap(pd->data, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            fprintf(stderr, "Memory allocation error.\n");
+            exit(1);
+        }
+        pd->data = p;
+    }
+    else if (new_bytes >= GDYN_MMAP_THRESHOLD) {
+        void* p = map_block(new_bytes);
+        if (pd->size > 0)
+            memcpy(p, pd->data, pd->size * pd->elem_size);
+        free(pd->data);
+        pd->data = p;
+        pd->mapped = 1;
+    }
+    else if (pd->mapped) {
+        void* p = ecmalloc(new_bytes);
+        if (pd->size > 0)
+            memcpy(p, pd->data, pd->size * pd->elem_size);
+        munmap(pd->data, old_bytes);
+        pd->data = p;
+        pd->mapped = 0;
+    }
+    else
+#endif
+    {
+        (void)old_bytes;
+        pd->data = ecrealloc(pd->data, new_bytes);
+    }
+    pd->capacity = new_capacity;
+}
+
+static void grow_for(GDynarray* pd, size_t required) {
+    static const double growth_factor = 2;
+    if (required <= pd->capacity)
+        return;
+
+    size_t new_capacity = (size_t)(growth_factor * pd->capacity);
+    if (new_capacity < required)
+        new_capacity = required;
+    set_capacity(pd, new_capacity);
+}
+
+void gdyn_reserve(GDynarray* pd, size_t new_capacity) {
+    if (new_capacity <= pd->capacity)
+        return;
+    set_capacity(pd, new_capacity);
+}
+
+void gdyn_resize(GDynarray* pd, size_t new_size) {
+    grow_for(pd, new_size);
+    pd->size = new_size;
+}
+
+void gdyn_shrink_to_fit(GDynarray* pd) {
+    if (pd->capacity != pd->size)
+        set_capacity(pd, pd->size);
+}
+
+/* If p points into the array, returns its offset in bytes plus one, otherwise 0 */
+static size_t offset_inside(const GDynarray* pd, const void* p) {
+    uintptr_t begin = (uintptr_t)pd->data;
+    uintptr_t end = begin + pd->size * pd->elem_size;
+    if ((uintptr_t)p >= begin && (uintptr_t)p < end)
+        return (size_t)((uintptr_t)p - begin) + 1;
+    return 0;
+}
+
+void gdyn_push_back(GDynarray* pd, const void* elem) {
+    size_t inside = offset_inside(pd, elem);
+    grow_for(pd, pd->size + 1);
+    if (inside)
+        elem = (char*)pd->data + inside - 1;
+    memcpy((char*)pd->data + pd->size * pd->elem_size, elem, pd->elem_size);
+    pd->size += 1;
+}
+
+void gdyn_append_n(GDynarray* pd, const void* elems, size_t n) {
+    if (n == 0)
+        return;
+    size_t inside = offset_inside(pd, elems);
+    grow_for(pd, pd->size + n);
+    if (inside)
+        elems = (char*)pd->data + inside - 1;
+    memcpy((char*)pd->data + pd->size * pd->elem_size, elems, n * pd->elem_size);
+    pd->size += n;
+}
+
+void gdyn_insert(GDynarray* pd, size_t index, const void* elems, size_t n) {
+    assert(index <= pd->size);
+    if (n == 0)
+        return;
+
+    /* elems may point into the array itself: then take a copy, growth and the shift would move it */
+    void* copy = NULL;
+    if (offset_inside(pd, elems)) {
+        copy = ecmalloc(n * pd->elem_size);
+        memcpy(copy, elems, n * pd->elem_size);
+        elems = copy;
+    }
+
+    grow_for(pd, pd->size + n);
+
+    char* at = (char*)pd->data + index * pd->elem_size;
+    memmove(at + n * pd->elem_size, at, (pd->size - index) * pd->elem_size);
+    memcpy(at, elems, n * pd->elem_size);
+    pd->size += n;
+    free(copy);
+}
+
+void gdyn_erase(GDynarray* pd, size_t index, size_t n) {
+    assert(index <= pd->size && n <= pd->size - index);
+    char* at = (char*)pd->data + index * pd->elem_size;
+    memmove(at, at + n * pd->elem_size, (pd->size - index - n) * pd->elem_size);
+    pd->size -= n;
+}
+
+void* gdyn_get(const GDynarray* pd, size_t index) {
+    assert(index < pd->size);
+    return (char*)pd->data + index * pd->elem_size;
+}
+
+void gdyn_set(GDynarray* pd, size_t index, const void* elem) {
+    assert(index < pd->size);
+    memcpy((char*)pd->data + index * pd->elem_size, elem, pd->elem_size);
+}
+
+void gdyn_destroy(GDynarray* pd) {
+#ifdef __linux__
+    if (pd->mapped)
+        munmap(pd->data, pd->capacity * pd->elem_size);
+    else
+#endif
+        free(pd->data);
+    pd->data = NULL;
+    pd->size = 0;
+    pd->capacity = 0;
+    pd->mapped = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef GENERIC_DYNAMIC_ARRAY_H
+#define GENERIC_DYNAMIC_ARRAY_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dynamic array of elements of arbitrary size elem_size.
+ * Memory grows with realloc; on Linux arrays of at least GDYN_MMAP_THRESHOLD bytes
+ * are moved to an anonymous mapping and grow with mremap, so no copying is done at all.
+ */
+
+#define GDYN_MMAP_THRESHOLD ((size_t)64 * 1024 * 1024)
+
+struct gdynarray {
+    void* data;
+    size_t size;
+    size_t capacity;
+    size_t elem_size;
+    int mapped;
+};
+typedef struct gdynarray GDynarray;
+
+#define GDYN_AT(pd, type, index) (((type*)(pd)->data)[index])
+
+void gdyn_init(GDynarray* pd, size_t elem_size, size_t initial_size);
+void gdyn_reserve(GDynarray* pd, size_t new_capacity);
+void gdyn_resize(GDynarray* pd, size_t new_size);
+void gdyn_shrink_to_fit(GDynarray* pd);
+void gdyn_push_back(GDynarray* pd, const void* elem);
+void gdyn_append_n(GDynarray* pd, const void* elems, size_t n);
+void gdyn_insert(GDynarray* pd, size_t index, const void* elems, size_t n);
+void gdyn_erase(GDynarray* pd, size_t index, size_t n);
+void* gdyn_get(const GDynarray* pd, size_t index);
+void gdyn_set(GDynarray* pd, size_t index, const void* elem);
+void gdyn_destroy(GDynarray* pd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,315 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "mdynarray.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MDYN_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define MDYN_HAS_WIN32
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#endif
+
+static size_t file_size_for(size_t capacity) {
+    return sizeof(struct mdynarray_header) + capacity * sizeof(int);
+}
+
+static void attach(MDynarray* pd, void* p) {
+    pd->header = (struct mdynarray_header*)p;
+    pd->data = (int*)(pd->header + 1);
+}
+
+static void fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(1);
+}
+
+/*
+ * Platform layer: open the file, find its length, extend it, map it, move the mapping to a new length,
+ * flush and unmap it. map_file returns NULL on failure, the rest return 0 on success.
+ */
+
+#if defined(MDYN_HAS_MMAP)
+
+static int open_file(const char* filename) {
+    return open(filename, O_RDWR | O_CREAT, 0644);
+}
+
+static int file_length(int fd, size_t* length) {
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return -1;
+    *length = (size_t)st.st_size;
+    return 0;
+}
+
+static int extend_file(int fd, size_t length) {
+    return ftruncate(fd, (off_t)length);
+}
+
+static void* map_file(int fd, size_t length) {
+    void* p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+static void unmap_file(void* p, size_t length) {
+    munmap(p, length);
+}
+
+static void* remap_file(int fd, void* p, size_t old_length, size_t new_length) {
+    if (extend_file(fd, new_length) != 0)
+        fail("Can't extend the array file.");
+#ifdef __linux__
+    /* mremap can move the mapping without unmapping it first */
+    p = mremap(p, old_length, new_length, MREMAP_MAYMOVE);
+    return p == MAP_FAILED ? NULL : p;
+#else
+    unmap_file(p, old_length);
+    return map_file(fd, new_length);
+#endif
+}
+
+static void flush_file(int fd, void* p, size_t length) {
+    (void)fd;
+    msync(p, length, MS_SYNC);
+}
+
+static void close_file(int fd) {
+    close(fd);
+}
+
+#elif defined(MDYN_HAS_WIN32)
+
+static int open_file(const char* filename) {
+    return _open(filename, _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+static int file_length(int fd, size_t* length) {
+    __int64 result = _filelengthi64(fd);
+    if (result < 0)
+        return -1;
+    *length = (size_t)result;
+    return 0;
+}
+
+static int extend_file(int fd, size_t length) {
+    return _chsize_s(fd, (__int64)length) == 0 ? 0 : -1;
+}
+
+/* The view keeps the file mapping object alive, so its handle can be closed right away */
+static void* map_file(int fd, size_t length) {
+    HANDLE mapping = CreateFileMappingA((HANDLE)_get_osfhandle(fd), NULL, PAGE_READWRITE, 0, 0, NULL);
+    if (mapping == NULL)
+        return NULL;
+    void* p = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, length);
+    CloseHandle(mapping);
+    return p;
+}
+
+static void unmap_file(void* p, size_t length) {
+    (void)length;
+    UnmapViewOfFile(p);
+}
+
+/* Windows can't move a view, and a mapped file can't change its size, so the view is unmapped first */
+static void* remap_file(int fd, void* p, size_t old_length, size_t new_length) {
+    unmap_file(p, old_length);
+    if (extend_file(fd, new_length) != 0)
+        fail("Can't extend the array file.");
+    return map_file(fd, new_length);
+}
+
+static void flush_file(int fd, void* p, size_t length) {
+    FlushViewOfFile(p, length);
+    FlushFileBuffers((HANDLE)_get_osfhandle(fd));
+}
+
+static void close_file(int fd) {
+    _close(fd);
+}
+
+#else
+
+static int open_file(const char* filename) {
+    (void)filename;
+    fail("Memory-mapped arrays are not supported on this system.");
+    return -1;
+}
+
+static int file_length(int fd, size_t* length) {
+    (void)fd;
+    (void)length;
+    return -1;
+}
+
+static int extend_file(int fd, size_t length) {
+    (void)fd;
+    (void)length;
+    return -1;
+}
+
+static void* map_file(int fd, size_t length) {
+    (void)fd;
+    (void)length;
+    return NULL;
+}
+
+static void unmap_file(void* p, size_t length) {
+    (void)p;
+    (void)length;
+}
+
+static void* remap_file(int fd, void* p, size_t old_length, size_t new_length) {
+    (void)fd;
+    (void)p;
+    (void)old_length;
+    (void)new_length;
+    return NULL;
+}
+
+static void flush_file(int fd, void* p, size_t length) {
+    (void)fd;
+    (void)p;
+    (void)length;
+}
+
+static void close_file(int fd) {
+    (void)fd;
+}
+
+#endif
+
+int mdyn_open(MDynarray* pd, const char* filename) {
+    pd->header = NULL;
+    pd->data = NULL;
+    pd->fd = open_file(filename);
+    if (pd->fd < 0)
+        return -1;
+
+    size_t length;
+    if (file_length(pd->fd, &length) != 0)
+        goto error;
+
+    int created = length == 0;
+    if (created) {
+        length = file_size_for(0);
+        if (extend_file(pd->fd, length) != 0)
+            goto error;
+    }
+    else if (length < sizeof(struct mdynarray_header) ||
+             (length - sizeof(struct mdynarray_header)) % sizeof(int) != 0)
+        goto error;
+
+    void* p = map_file(pd->fd, length);
+    if (p == NULL)
+        goto error;
+    attach(pd, p);
+
+    if (created) {
+        memcpy(pd->header->magic, MDYN_MAGIC, sizeof(pd->header->magic));
+        pd->header->size = 0;
+        pd->header->capacity = 0;
+        return 0;
+    }
+
+    /*
+     * mdyn_reserve extends the file before it records the new capacity, so a crash between the two
+     * leaves a file longer than the header says. The extra elements are unused, take them as capacity.
+     */
+    if (memcmp(pd->header->magic, MDYN_MAGIC, sizeof(pd->header->magic)) != 0 ||
+        file_size_for(pd->header->capacity) > length || pd->header->size > pd->header->capacity) {
+        unmap_file(p, length);
+        goto error;
+    }
+    pd->header->capacity = (length - sizeof(struct mdynarray_header)) / sizeof(int);
+    return 0;
+
+error:
+    close_file(pd->fd);
+    pd->header = NULL;
+    pd->data = NULL;
+    pd->fd = -1;
+    return -1;
+}
+
+void mdyn_reserve(MDynarray* pd, size_t new_capacity) {
+    size_t old_length = file_size_for(pd->header->capacity);
+    size_t new_length = file_size_for(new_capacity);
+    if (new_capacity <= pd->header->capacity)
+        return;
+
+    void* p = remap_file(pd->fd, pd->header, old_length, new_length);
+    if (p == NULL)
+        fail("Can't map the array file.");
+
+    attach(pd, p);
+    pd->header->capacity = new_capacity;
+}
+
+void mdyn_sync(MDynarray* pd) {
+    flush_file(pd->fd, pd->header, file_size_for(pd->header->capacity));
+}
+
+void mdyn_close(MDynarray* pd) {
+    if (pd->header == NULL)
+        return;
+    unmap_file(pd->header, file_size_for(pd->header->capacity));
+    close_file(pd->fd);
+    pd->header = NULL;
+    pd->data = NULL;
+    pd->fd = -1;
+}
+
+size_t mdyn_size(const MDynarray* pd) {
+    return (size_t)pd->header->size;
+}
+
+static void grow_for(MDynarray* pd, size_t required) {
+    static const double growth_factor = 2;
+    if (required <= pd->header->capacity)
+        return;
+
+    size_t new_capacity = (size_t)(growth_factor * pd->header->capacity);
+    if (new_capacity < required)
+        new_capacity = required;
+    mdyn_reserve(pd, new_capacity);
+}
+
+void mdyn_resize(MDynarray* pd, size_t new_size) {
+    grow_for(pd, new_size);
+    pd->header->size = new_size;
+}
+
+void mdyn_push_back(MDynarray* pd, int x) {
+    grow_for(pd, pd->header->size + 1);
+    pd->data[pd->header->size] = x;
+    pd->header->size += 1;
+}
+
+void mdyn_append_n(MDynarray* pd, const int* values, size_t n) {
+    grow_for(pd, pd->header->size + n);
+    memcpy(pd->data + pd->header->size, values, n * sizeof(int));
+    pd->header->size += n;
+}
+
+int mdyn_get(const MDynarray* pd, size_t index) {
+    assert(index < pd->header->size);
+    return pd->data[index];
+}
+
+void mdyn_set(MDynarray* pd, size_t index, int value) {
+    assert(index < pd->header->size);
+    pd->data[index] = value;
+}
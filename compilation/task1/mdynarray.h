@@ -0,0 +1,58 @@
+#ifndef MAPPED_DYNAMIC_ARRAY_H
+#define MAPPED_DYNAMIC_ARRAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dynamic array of int stored in a memory-mapped file.
+ * The file is a 64-byte header (magic, size, capacity) followed by the elements, exactly as they lie
+ * in memory, so opening an existing array only maps the file - nothing is read or parsed.
+ * Changes go straight to the file; mdyn_sync forces them to disk, mdyn_close unmaps the file.
+ *
+ * The array grows by extending the file and mapping it again (with mremap on Linux, so the mapping
+ * can move without being unmapped first). POSIX systems use mmap, Windows uses CreateFileMapping
+ * and MapViewOfFile; on other systems mdyn_open reports an error and exits.
+ * The file is extended before the new capacity is written to the header, and mdyn_open takes
+ * the capacity from the file length, so a crash in the middle of growing leaves a valid array.
+ *
+ * mdyn_open creates the file if it does not exist and returns 0 on success and -1 if the file
+ * cannot be opened or mapped, or is not an array file.
+ */
+
+#define MDYN_MAGIC "DYNARRAY"
+
+struct mdynarray_header {
+    char magic[8];
+    uint64_t size;
+    uint64_t capacity;
+    char reserved[40];
+};
+
+struct mdynarray {
+    struct mdynarray_header* header;
+    int* data;
+    int fd;
+};
+typedef struct mdynarray MDynarray;
+
+int mdyn_open(MDynarray* pd, const char* filename);
+size_t mdyn_size(const MDynarray* pd);
+void mdyn_reserve(MDynarray* pd, size_t new_capacity);
+void mdyn_resize(MDynarray* pd, size_t new_size);
+void mdyn_push_back(MDynarray* pd, int x);
+void mdyn_append_n(MDynarray* pd, const int* values, size_t n);
+int mdyn_get(const MDynarray* pd, size_t index);
+void mdyn_set(MDynarray* pd, size_t index, int value);
+void mdyn_sync(MDynarray* pd);
+void mdyn_close(MDynarray* pd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
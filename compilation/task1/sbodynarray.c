@@ -0,0 +1,75 @@
+#include "sbodynarray.h"
+#include "dynarray.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+static int is_inline(const SboDynarray* pd) {
+    return pd->capacity == SBO_INLINE_CAPACITY;
+}
+
+int* sbo_data(SboDynarray* pd) {
+    return is_inline(pd) ? pd->inline_data : pd->heap_data;
+}
+
+static const int* sbo_const_data(const SboDynarray* pd) {
+    return is_inline(pd) ? pd->inline_data : pd->heap_data;
+}
+
+void sbo_clear(SboDynarray* pd) {
+    memset(sbo_data(pd), 0, pd->size * sizeof(int));
+}
+
+void sbo_init(SboDynarray* pd, size_t initial_size) {
+    pd->size = 0;
+    pd->capacity = SBO_INLINE_CAPACITY;
+    sbo_reserve(pd, initial_size);
+    pd->size = initial_size;
+    sbo_clear(pd);
+}
+
+void sbo_reserve(SboDynarray* pd, size_t new_capacity) {
+    if (new_capacity <= pd->capacity)
+        return;
+
+    if (is_inline(pd)) {
+        int* heap = (int*)ecmalloc(new_capacity * sizeof(int));
+        memcpy(heap, pd->inline_data, pd->size * sizeof(int));
+        pd->heap_data = heap;
+    }
+    else
+        pd->heap_data = (int*)ecrealloc(pd->heap_data, new_capacity * sizeof(int));
+    pd->capacity = new_capacity;
+}
+
+void sbo_push_back(SboDynarray* pd, int x) {
+    static const double growth_factor = 2;
+    if (pd->size == pd->capacity)
+        sbo_reserve(pd, (size_t)(growth_factor * pd->capacity));
+    sbo_data(pd)[pd->size] = x;
+    pd->size += 1;
+}
+
+int sbo_get(const SboDynarray* pd, size_t index) {
+    assert(index < pd->size);
+    return sbo_const_data(pd)[index];
+}
+
+void sbo_set(SboDynarray* pd, size_t index, int value) {
+    assert(index < pd->size);
+    sbo_data(pd)[index] = value;
+}
+
+void sbo_print(const SboDynarray* pd) {
+    printf("sbodynarray: ");
+    for (size_t i = 0; i < pd->size; ++i)
+        printf("%i ", sbo_const_data(pd)[i]);
+    printf("\n");
+}
+
+void sbo_destroy(SboDynarray* pd) {
+    if (!is_inline(pd))
+        free(pd->heap_data);
+    pd->size = 0;
+    pd->capacity = SBO_INLINE_CAPACITY;
+}
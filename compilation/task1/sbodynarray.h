@@ -0,0 +1,46 @@
+#ifndef SBO_DYNAMIC_ARRAY_H
+#define SBO_DYNAMIC_ARRAY_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dynamic array of int with small buffer optimization.
+ * The first SBO_INLINE_CAPACITY elements are kept inside the struct itself, so small arrays
+ * never touch the heap. When the array grows past that, the elements move to a heap block
+ * allocated with ecmalloc. The functions are the same as for Dynarray, with the sbo_ prefix.
+ *
+ * Since the inline elements live in the struct, moving the struct (e.g. by assignment)
+ * invalidates pointers returned by sbo_data.
+ */
+
+#define SBO_INLINE_CAPACITY 8
+
+struct sbodynarray {
+    size_t size;
+    size_t capacity;  /* SBO_INLINE_CAPACITY while the elements are inline */
+    union {
+        int inline_data[SBO_INLINE_CAPACITY];
+        int* heap_data;
+    };
+};
+typedef struct sbodynarray SboDynarray;
+
+int* sbo_data(SboDynarray* pd);
+void sbo_clear(SboDynarray* pd);
+void sbo_init(SboDynarray* pd, size_t initial_size);
+void sbo_reserve(SboDynarray* pd, size_t new_capacity);
+void sbo_push_back(SboDynarray* pd, int x);
+int sbo_get(const SboDynarray* pd, size_t index);
+void sbo_set(SboDynarray* pd, size_t index, int value);
+void sbo_print(const SboDynarray* pd);
+void sbo_destroy(SboDynarray* pd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
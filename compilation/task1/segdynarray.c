@@ -0,0 +1,132 @@
+#include "segdynarray.h"
+#include "dynarray.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+static size_t chunk_size(size_t k) {
+    return SEG_FIRST_CHUNK << k;
+}
+
+/* Number of elements in chunks 0..k-1 */
+static size_t chunk_start(size_t k) {
+    return (SEG_FIRST_CHUNK << k) - SEG_FIRST_CHUNK;
+}
+
+static size_t log2_floor(size_t x) {
+#if defined(__GNUC__)
+    return 63 - (size_t)__builtin_clzll((unsigned long long)x);
+#else
+    size_t result = 0;
+    while (x >>= 1)
+        result++;
+    return result;
+#endif
+}
+
+/* Points tail to the element with index size, if it is already allocated */
+static void update_tail(SegDynarray* pd) {
+    if (pd->size == seg_capacity(pd)) {
+        pd->tail = NULL;
+        pd->tail_end = NULL;
+        return;
+    }
+    size_t k = log2_floor(pd->size + SEG_FIRST_CHUNK) - SEG_FIRST_CHUNK_BITS;
+    pd->tail = pd->chunks[k] + (pd->size - chunk_start(k));
+    pd->tail_end = pd->chunks[k] + chunk_size(k);
+}
+
+void seg_init(SegDynarray* pd) {
+    memset(pd->chunks, 0, sizeof(pd->chunks));
+    pd->size = 0;
+    pd->chunk_count = 0;
+    pd->tail = NULL;
+    pd->tail_end = NULL;
+}
+
+size_t seg_capacity(const SegDynarray* pd) {
+    return chunk_start(pd->chunk_count);
+}
+
+void seg_reserve(SegDynarray* pd, size_t new_capacity) {
+    while (seg_capacity(pd) < new_capacity) {
+        assert(pd->chunk_count < SEG_MAX_CHUNKS);
+        pd->chunks[pd->chunk_count] = (int*)ecmalloc(chunk_size(pd->chunk_count) * sizeof(int));
+        pd->chunk_count += 1;
+    }
+    update_tail(pd);
+}
+
+void seg_push_back(SegDynarray* pd, int x) {
+    if (pd->tail == pd->tail_end) {
+        if (pd->size == seg_capacity(pd))
+            seg_reserve(pd, pd->size + 1);
+        else
+            update_tail(pd);
+    }
+    *pd->tail++ = x;
+    pd->size += 1;
+}
+
+void seg_append_n(SegDynarray* pd, const int* values, size_t n) {
+    seg_reserve(pd, pd->size + n);
+    while (n > 0) {
+        size_t k = log2_floor(pd->size + SEG_FIRST_CHUNK) - SEG_FIRST_CHUNK_BITS;
+        size_t offset = pd->size - chunk_start(k);
+        size_t count = chunk_size(k) - offset;
+        if (count > n)
+            count = n;
+
+        memcpy(pd->chunks[k] + offset, values, count * sizeof(int));
+        values += count;
+        n -= count;
+        pd->size += count;
+    }
+    update_tail(pd);
+}
+
+int* seg_at(const SegDynarray* pd, size_t index) {
+    assert(index < seg_capacity(pd));
+    size_t k = log2_floor(index + SEG_FIRST_CHUNK) - SEG_FIRST_CHUNK_BITS;
+    return pd->chunks[k] + (index - chunk_start(k));
+}
+
+int seg_get(const SegDynarray* pd, size_t index) {
+    assert(index < pd->size);
+    return *seg_at(pd, index);
+}
+
+void seg_set(SegDynarray* pd, size_t index, int value) {
+    assert(index < pd->size);
+    *seg_at(pd, index) = value;
+}
+
+size_t seg_chunk_count(const SegDynarray* pd) {
+    if (pd->size == 0)
+        return 0;
+    return log2_floor(pd->size - 1 + SEG_FIRST_CHUNK) - SEG_FIRST_CHUNK_BITS + 1;
+}
+
+int* seg_chunk(const SegDynarray* pd, size_t k, size_t* length) {
+    assert(k < seg_chunk_count(pd));
+    size_t used = pd->size - chunk_start(k);
+    *length = used < chunk_size(k) ? used : chunk_size(k);
+    return pd->chunks[k];
+}
+
+void seg_print(const SegDynarray* pd) {
+    printf("segdynarray: ");
+    for (size_t k = 0; k < seg_chunk_count(pd); ++k) {
+        size_t length;
+        const int* chunk = seg_chunk(pd, k, &length);
+        for (size_t i = 0; i < length; ++i)
+            printf("%i ", chunk[i]);
+    }
+    printf("\n");
+}
+
+void seg_destroy(SegDynarray* pd) {
+    for (size_t k = 0; k < pd->chunk_count; ++k)
+        free(pd->chunks[k]);
+    seg_init(pd);
+}
@@ -0,0 +1,57 @@
+#ifndef SEGMENTED_DYNAMIC_ARRAY_H
+#define SEGMENTED_DYNAMIC_ARRAY_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Segmented dynamic array of int.
+ * Elements are kept in chunks of sizes SEG_FIRST_CHUNK, 2 * SEG_FIRST_CHUNK, 4 * SEG_FIRST_CHUNK, ...
+ * When the array grows only a new chunk is allocated, existing elements are never moved,
+ * so pointers returned by seg_at stay valid until seg_destroy.
+ *
+ * Element i lives in chunk k = log2(i + SEG_FIRST_CHUNK) - log2(SEG_FIRST_CHUNK)
+ * at offset i + SEG_FIRST_CHUNK - (SEG_FIRST_CHUNK << k), so indexing is O(1).
+ *
+ * Iteration by chunk:
+ *     for (size_t k = 0; k < seg_chunk_count(&a); ++k) {
+ *         size_t length;
+ *         int* chunk = seg_chunk(&a, k, &length);
+ *         ...
+ *     }
+ */
+
+#define SEG_FIRST_CHUNK_BITS 6
+#define SEG_FIRST_CHUNK ((size_t)1 << SEG_FIRST_CHUNK_BITS)
+#define SEG_MAX_CHUNKS (sizeof(size_t) * 8 - SEG_FIRST_CHUNK_BITS)
+
+struct segdynarray {
+    int* chunks[SEG_MAX_CHUNKS];
+    size_t size;
+    size_t chunk_count;
+    int* tail;      /* place of the next push_back */
+    int* tail_end;  /* end of the chunk that contains tail */
+};
+typedef struct segdynarray SegDynarray;
+
+void seg_init(SegDynarray* pd);
+void seg_reserve(SegDynarray* pd, size_t new_capacity);
+size_t seg_capacity(const SegDynarray* pd);
+void seg_push_back(SegDynarray* pd, int x);
+void seg_append_n(SegDynarray* pd, const int* values, size_t n);
+int* seg_at(const SegDynarray* pd, size_t index);
+int seg_get(const SegDynarray* pd, size_t index);
+void seg_set(SegDynarray* pd, size_t index, int value);
+size_t seg_chunk_count(const SegDynarray* pd);
+int* seg_chunk(const SegDynarray* pd, size_t k, size_t* length);
+void seg_print(const SegDynarray* pd);
+void seg_destroy(SegDynarray* pd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,13 +1,26 @@
 @echo off
 
+rem Чтобы включить замеры времени операций (image_profiler.hpp), добавьте -DIMAGE_ENABLE_PROFILING
+rem ко всем командам компиляции библиотеки.
+
 mkdir build
 cd build
 
-g++ -std=c++20 -I..\include -I..\external\stb -c ..\src\image.cpp -o image.o
+g++ -std=c++20 -O2 -I..\include -I..\external\stb -c ..\src\image.cpp -o image.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\image_buffer_pool.cpp -o image_buffer_pool.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\planar_image.cpp -o planar_image.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\image_metrics.cpp -o image_metrics.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\color_convert.cpp -o color_convert.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\indexed_image.cpp -o indexed_image.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\sparse_image.cpp -o sparse_image.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\image_graph.cpp -o image_graph.o
+g++ -std=c++20 -O2 -I..\include -c ..\src\image_profiler.cpp -o image_profiler.o
 
-ar rcs libimage.a image.o
+ar rcs libimage.a image.o image_buffer_pool.o planar_image.o image_metrics.o color_convert.o indexed_image.o ^
+    sparse_image.o image_graph.o image_profiler.o
 
-g++ -std=c++20 -I..\include -I..\external\stb ..\src\main.cpp -L. -limage -o image_app.exe
+g++ -std=c++20 -O2 -I..\include -I..\external\stb ..\src\main.cpp -L. -limage -o image_app.exe
+g++ -std=c++20 -O2 -I..\include ..\src\benchmark.cpp -L. -limage -o image_bench.exe
 
 copy ..\zlatoust1910.jpg .
 
@@ -0,0 +1,48 @@
+/*
+    Преобразования цветовых пространств
+
+    Функции из этого файла переводят всё изображение целиком из RGB в другие цветовые модели и обратно.
+    Изображение обрабатывается по строкам: строка раскладывается на три плоскости R, G, B
+    (PlanarImage::deinterleave), над плоскостями работает векторное ядро, результат собирается обратно.
+    Строки делятся между потоками (threads - число потоков, 0 - по числу ядер процессора).
+
+    8-битные преобразования (YCbCr, яркость) считаются в целых числах с фиксированной точкой
+    по 16 пикселей за раз (SSE2), погрешность - не больше единицы в последнем разряде.
+
+        rgbToYCbCr(image, standard)     -   RGB -> YCbCr (полный диапазон 0..255, как в JPEG).
+                                            В результате вместо r, g, b лежат Y, Cb, Cr.
+        yCbCrToRgb(image, standard)     -   обратное преобразование
+        toGrayscale(image, standard)    -   яркость Y, один байт на пиксель
+        rgbToHsv(image)                 -   RGB -> HSV. Тон H растянут на 0..255 (вместо 0..360 градусов),
+                                            насыщенность S и значение V - на 0..255
+        hsvToRgb(image)                 -   обратное преобразование
+        toLinear(image)                 -   sRGB -> линейная интенсивность, 3 float от 0 до 1 на пиксель
+        rgbToLab(image)                 -   sRGB -> CIE L*a*b* (белая точка D65), 3 float на пиксель
+        labToRgb(lab, width, height)    -   CIE L*a*b* -> sRGB
+
+    Стандарт YCbCrStandard::Bt601 используется в JPEG и SD видео, Bt709 - в HD видео.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "image.hpp"
+
+enum class YCbCrStandard
+{
+    Bt601,
+    Bt709
+};
+
+Image rgbToYCbCr(const Image& image, YCbCrStandard standard = YCbCrStandard::Bt601, int threads = 0);
+Image yCbCrToRgb(const Image& image, YCbCrStandard standard = YCbCrStandard::Bt601, int threads = 0);
+std::vector<unsigned char> toGrayscale(const Image& image, YCbCrStandard standard = YCbCrStandard::Bt601,
+                                       int threads = 0);
+
+Image rgbToHsv(const Image& image, int threads = 0);
+Image hsvToRgb(const Image& image, int threads = 0);
+
+std::vector<float> toLinear(const Image& image, int threads = 0);
+std::vector<float> rgbToLab(const Image& image, int threads = 0);
+Image labToRgb(const std::vector<float>& lab, int width, int height, int threads = 0);
@@ -10,6 +10,8 @@
         mData   -   здесь хранятся цвета всех пикселей по цветовой модели RGB.
                     Цвет описывается тремя однобайтовыми числами (красная, зелёная и синяя компоненты)
                     Соответственно размер этого массива равен  3 * mWidth * mHeight.
+                    Память под mData берётся из пула ImageBufferPool (см. image_buffer_pool.hpp),
+                    поэтому повторное создание изображений того же размера не обращается к malloc.
 
     Внутренний класс Color - вспомогательный класс, для хранения цвета.
     Для класса Color перегруженны операторы + и += чтобы цвета можно было удобно складывать.
@@ -27,13 +29,68 @@
 
         Image(int width, int height)            -   создаёт изображение размера width на height черного цвета.
         Image(int width, int height, Color c)   -   создаёт изображение размера width на height цвета c.
+        Image(int width, int height, ImageBufferPool& pool)
+                                                -   то же, что Image(width, height), но память берётся
+                                                    из пула pool, а не из глобального пула.
         getWidth, getHeight, getData            -   геттеры для полей класса
 
         setPixel(int i, int j, Color c)         -   задать цвет пикселя с координатами (i, j) цветом c
         getPixel(int i, int j)                  -   получить цвет пикселя с координатами (i, j)
 
+        Быстрый доступ к пикселям. Color занимает ровно 3 байта, поэтому mData можно рассматривать
+        как массив Color размера mWidth * mHeight:
+
+        at<Access>(int i, int j)                -   ссылка на пиксель (i, j) без пересчёта через setPixel/getPixel
+        row<Access>(int j)                      -   строка j в виде std::span<Color> длины mWidth
+        pixels()                                -   все пиксели в виде std::span<Color>
+        begin(), end()                          -   указатели на первый и за последний пиксель. Это непрерывные
+                                                    итераторы, поэтому их можно передавать в алгоритмы <algorithm>,
+                                                    в том числе в параллельные: std::for_each(std::execution::par,
+                                                    im.begin(), im.end(), f)
+
+        Проверка границ задаётся на этапе компиляции параметром Access:
+            Image::CheckedAccess    -   при выходе за границы печатает ошибку и завершает программу
+            Image::UncheckedAccess  -   без проверки
+            Image::DefaultAccess    -   CheckedAccess, если не определены NDEBUG или IMAGE_UNCHECKED_ACCESS,
+                                        иначе UncheckedAccess
+
+        load(const std::string& filename)       -   загрузить картинку, формат определяется по расширению файла:
+                                                    .ppm, .jpg/.jpeg, а также .png, .bmp, .tga и .pgm
+                                                    (последние четыре - через loadFromMemory)
+        loadFromMemory(std::span<const std::byte> bytes)
+                                                -   загрузить картинку из массива байт в памяти (например, из
+                                                    сетевого буфера). Формат определяется по первым байтам
+                                                    (см. detectFormat). PPM P6 разбирается без промежуточного
+                                                    буфера: пиксели копируются прямо в mData одним memcpy.
+                                                    Остальные форматы декодируются через stb_image, серые
+                                                    картинки (PGM, серый PNG) превращаются в RGB.
+        detectFormat(std::span<const std::byte> bytes)
+                                                -   статическая функция: определить формат по сигнатуре
+                                                    (P6, P5, JPEG, PNG, BMP). У TGA сигнатуры нет, поэтому всё
+                                                    нераспознанное возвращается как Format::Unknown и отдаётся stb.
         loadPpm(const std::string& filename)    -   загрузить картинку в формате PPM из файла под названием filename
-        savePpm(const std::string& filename)    -   сохранить картинку в формате PPM в файл под названием filename
+        savePpm(const std::string& filename)    -   сохранить картинку в формате PPM в файл под названием filename.
+                                                    Заголовок и пиксели записываются одним системным вызовом writev
+                                                    (на Windows - через std::ofstream).
+
+        saveJpeg(const std::string& filename, const JpegOptions& options)
+                                                -   сохранить картинку в формате JPEG с настройками options
+        writeJpeg(const WriteCallback& write, const JpegOptions& options)
+                                                -   закодировать картинку в JPEG и отдавать байты функции write
+                                                    по мере готовности (через stbi_write_jpg_to_func), без файла
+        encodeJpeg(const JpegOptions& options)  -   закодировать картинку в JPEG и вернуть байты в std::vector
+        encodePpm()                             -   то же для формата PPM P6
+        encodeJpegBatch(images, options, threads)
+                                                -   статическая функция: закодировать в JPEG несколько независимых
+                                                    картинок параллельно в threads потоках (0 - по числу ядер)
+
+    Внутренний класс JpegOptions - настройки JPEG кодировщика:
+        quality     -   качество от 1 до 100 (по умолчанию 90, как было раньше)
+        subsampling -   прореживание цветовых каналов. Кодировщик stb_image_write сам включает 4:2:0
+                        при quality <= 90 и выключает (4:4:4) при quality > 90, поэтому:
+                        Auto   - решает stb по качеству,
+                        Yuv420 - качество ограничивается сверху значением 90,
+                        Yuv444 - качество поднимается минимум до 91.
 
         drawCircle(int radius, int centerX, int centerY, Color c) 
                                                 -   нарисовать на картинке круг радиусом radius с центром 
@@ -49,14 +106,25 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <span>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+#include "image_buffer_pool.hpp"
 
 class Image
 {
+public:
+
+    using Buffer = std::vector<unsigned char, ImageBufferPool::Allocator<unsigned char>>;
+
 private:
 
     int mWidth  {0};
     int mHeight {0};
-    std::vector<unsigned char> mData {};
+    Buffer mData {};
 
 public:
 
@@ -71,19 +139,131 @@ public:
         static unsigned char saturateCast(int a);
     };
 
+    struct CheckedAccess
+    {
+        static void check(int i, int j, int width, int height)
+        {
+            if (i < 0 || i >= width || j < 0 || j >= height)
+            {
+                std::cout << "Error. Pixel (" << i << ", " << j << ") is out of image bounds!" << std::endl;
+                std::exit(1);
+            }
+        }
+    };
+
+    struct UncheckedAccess
+    {
+        static void check(int, int, int, int)
+        {
+        }
+    };
+
+#if defined(NDEBUG) || defined(IMAGE_UNCHECKED_ACCESS)
+    using DefaultAccess = UncheckedAccess;
+#else
+    using DefaultAccess = CheckedAccess;
+#endif
+
+    enum class ChromaSubsampling
+    {
+        Auto,
+        Yuv420,
+        Yuv444
+    };
+
+    struct JpegOptions
+    {
+        int quality {90};
+        ChromaSubsampling subsampling {ChromaSubsampling::Auto};
+    };
+
+    using WriteCallback = std::function<void(const void* data, int size)>;
+
+    enum class Format
+    {
+        Unknown,
+        Ppm,
+        Pgm,
+        Jpeg,
+        Png,
+        Bmp
+    };
+
     Image();
     Image(const std::string& filename);
     Image(int width, int height);
     Image(int width, int height, Color c);
+    Image(int width, int height, ImageBufferPool& pool);
 
     int getWidth() const;
     int getHeight() const;
     unsigned char* getData();
+    const unsigned char* getData() const;
 
     void setPixel(int i, int j, Color c);
     Color getPixel(int i, int j) const;
 
+    template <typename Access = DefaultAccess>
+    Color& at(int i, int j)
+    {
+        Access::check(i, j, mWidth, mHeight);
+        return begin()[static_cast<std::size_t>(j) * mWidth + i];
+    }
+
+    template <typename Access = DefaultAccess>
+    const Color& at(int i, int j) const
+    {
+        Access::check(i, j, mWidth, mHeight);
+        return begin()[static_cast<std::size_t>(j) * mWidth + i];
+    }
+
+    template <typename Access = DefaultAccess>
+    std::span<Color> row(int j)
+    {
+        Access::check(0, j, 1, mHeight);
+        return {begin() + static_cast<std::size_t>(j) * mWidth, static_cast<std::size_t>(mWidth)};
+    }
+
+    template <typename Access = DefaultAccess>
+    std::span<const Color> row(int j) const
+    {
+        Access::check(0, j, 1, mHeight);
+        return {begin() + static_cast<std::size_t>(j) * mWidth, static_cast<std::size_t>(mWidth)};
+    }
+
+    std::span<Color> pixels()
+    {
+        return {begin(), end()};
+    }
+
+    std::span<const Color> pixels() const
+    {
+        return {begin(), end()};
+    }
+
+    Color* begin()
+    {
+        return reinterpret_cast<Color*>(mData.data());
+    }
+
+    Color* end()
+    {
+        return begin() + mData.size() / 3;
+    }
+
+    const Color* begin() const
+    {
+        return reinterpret_cast<const Color*>(mData.data());
+    }
+
+    const Color* end() const
+    {
+        return begin() + mData.size() / 3;
+    }
+
     void load(const std::string& filename);
+    void loadFromMemory(std::span<const std::byte> bytes);
+    static Format detectFormat(std::span<const std::byte> bytes);
     void save(const std::string& filename) const;
 
     void loadPpm(const std::string& filename);
@@ -91,7 +271,28 @@ public:
 
     void loadJpeg(const std::string& filename);
     void saveJpeg(const std::string& filename) const;
+    void saveJpeg(const std::string& filename, const JpegOptions& options) const;
+
+    void writeJpeg(const WriteCallback& write) const;
+    void writeJpeg(const WriteCallback& write, const JpegOptions& options) const;
+    std::vector<unsigned char> encodeJpeg() const;
+    std::vector<unsigned char> encodeJpeg(const JpegOptions& options) const;
+    std::vector<unsigned char> encodePpm() const;
+
+    static std::vector<std::vector<unsigned char>> encodeJpegBatch(const std::vector<const Image*>& images);
+    static std::vector<std::vector<unsigned char>> encodeJpegBatch(const std::vector<const Image*>& images,
+                                                                   const JpegOptions& options, int threads);
 
     void drawCircle(int radius, int centerX, int centerY, Color c);
     void drawLine(int x1, int y1, int x2, int y2, Color c);
-};
\ No newline at end of file
+
+private:
+
+    std::string ppmHeader() const;
+    bool loadPpmFromMemory(std::span<const std::byte> bytes);
+    void loadWithStb(std::span<const std::byte> bytes);
+    static int effectiveQuality(const JpegOptions& options);
+};
+
+static_assert(sizeof(Image::Color) == 3 && alignof(Image::Color) == 1,
+              "Image::Color must have the same layout as 3 bytes of mData");
\ No newline at end of file
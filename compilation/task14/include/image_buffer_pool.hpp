@@ -0,0 +1,119 @@
+/*
+    Пул буферов для изображений
+
+    Класс ImageBufferPool переиспользует память под пиксели изображений. Когда изображение уничтожается,
+    его буфер не возвращается в malloc, а кладётся в список свободных буферов своего размерного класса.
+    Следующее изображение такого же (или близкого) размера получит этот же буфер без обращения к системе.
+    Это особенно полезно при обработке потока кадров одинакового размера.
+
+    Размерные классы: до 256 байт - кратные 64, дальше по 4 класса на каждую степень двойки,
+    то есть перерасход памяти не больше 25%.
+    Все буферы выровнены на 64 байта (размер кэш-линии).
+    Если пул создан с useHugePages = true, то на Linux большие буферы (от 2 МБ) выравниваются на 2 МБ
+    и помечаются через madvise(MADV_HUGEPAGE), чтобы ядро отдало их огромными страницами.
+
+    Методы класса ImageBufferPool:
+
+        allocate(size_t size)                   -   выделить буфер размером не меньше size байт
+        deallocate(void* p, size_t size)        -   вернуть буфер в пул (size - тот же, что при выделении)
+        trim()                                  -   освободить все закэшированные буферы
+        getStats(), resetStats()                -   статистика: попадания, промахи, возвраты, объём кэша
+        printStats()                            -   напечатать статистику в std::cout
+        global()                                -   общий пул, который по умолчанию используют все Image
+
+    Внутренний шаблон Allocator<T> - аллокатор для стандартных контейнеров, берущий память из пула.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+class ImageBufferPool
+{
+public:
+
+    struct Stats
+    {
+        std::size_t hits        {0};
+        std::size_t misses      {0};
+        std::size_t releases    {0};
+        std::size_t cachedBytes {0};
+    };
+
+    static constexpr std::size_t alignment = 64;
+    static constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+    explicit ImageBufferPool(bool useHugePages = false, std::size_t maxCachedBytes = std::size_t(1) << 30);
+    ~ImageBufferPool();
+
+    ImageBufferPool(const ImageBufferPool&) = delete;
+    ImageBufferPool& operator=(const ImageBufferPool&) = delete;
+
+    void* allocate(std::size_t size);
+    void deallocate(void* p, std::size_t size);
+    void trim();
+
+    Stats getStats() const;
+    void resetStats();
+    void printStats() const;
+
+    static ImageBufferPool& global();
+
+
+    template <typename T>
+    class Allocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        Allocator() noexcept : mPool(&ImageBufferPool::global()) {}
+        Allocator(ImageBufferPool& pool) noexcept : mPool(&pool) {}
+
+        template <typename U>
+        Allocator(const Allocator<U>& other) noexcept : mPool(other.getPool()) {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(mPool->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            mPool->deallocate(p, n * sizeof(T));
+        }
+
+        ImageBufferPool* getPool() const noexcept
+        {
+            return mPool;
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U>& other) const noexcept
+        {
+            return mPool == other.getPool();
+        }
+
+    private:
+        ImageBufferPool* mPool;
+    };
+
+private:
+
+    static std::size_t bucketSize(std::size_t size);
+    std::size_t allocationSize(std::size_t bucket) const;
+    void* allocateBlock(std::size_t bucket);
+    static void freeBlock(void* p);
+
+    bool mUseHugePages;
+    std::size_t mMaxCachedBytes;
+
+    mutable std::mutex mMutex;
+    std::map<std::size_t, std::vector<void*>> mFreeLists;
+    Stats mStats {};
+};
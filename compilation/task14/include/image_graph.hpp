@@ -0,0 +1,120 @@
+/*
+    Граф операций над изображениями
+
+    Класс ImageGraph позволяет сначала описать цепочку операций (загрузить, уменьшить, перевести в серое,
+    размыть, нарисовать, сохранить), а потом выполнить её целиком методом run.
+    Методы добавления операций ничего не вычисляют, а только возвращают номер узла графа (NodeId),
+    который можно передать следующей операции. Из одного узла может выходить несколько ветвей.
+
+    При запуске граф планируется:
+        -   поточечные операции (grayscale, lut), идущие подряд, объединяются в одну стадию.
+            Несколько lut подряд сливаются в одну таблицу. Стадия проходит изображение полосами
+            по несколько строк, и каждая полоса проходит через все операции стадии, пока лежит в кэше,
+            вместо того чтобы каждая операция делала свой полный проход и своё промежуточное изображение;
+        -   результат узла хранится, только если он нужен нескольким потребителям или помечен через keep;
+        -   независимые ветви (стадии, которые не зависят друг от друга) выполняются параллельно.
+
+    Методы класса ImageGraph:
+
+        load(const std::string& filename)       -   узел-источник: загрузить изображение (Image::load)
+        input(const Image& image)               -   узел-источник: готовое изображение
+        resize(NodeId node, int width, int height)
+                                                -   изменить размер (билинейная интерполяция)
+        grayscale(NodeId node)                  -   перевести в оттенки серого (поточечная)
+        lut(NodeId node, const Lut& table)      -   заменить каждую компоненту c на table[c] (поточечная)
+        blur(NodeId node, int radius)           -   размытие квадратным окном (2 * radius + 1)^2
+        draw(NodeId node, DrawFunction f)       -   вызвать f(Image&) на копии изображения (рисование и т.п.)
+        apply(NodeId node, ApplyFunction f)     -   результат f(const Image&), например rgbToYCbCr
+        save(NodeId node, const std::string& filename)
+                                                -   сохранить изображение (Image::save), результат - тот же
+
+        keep(NodeId node)                       -   сохранить результат узла, чтобы его можно было получить result
+        run(int threads)                        -   выполнить граф (threads - число потоков, 0 - по числу ядер)
+        result(NodeId node)                     -   результат узла после run
+*/
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "image.hpp"
+
+class ImageGraph
+{
+public:
+
+    using NodeId = int;
+    using Lut = std::array<unsigned char, 256>;
+    using DrawFunction = std::function<void(Image&)>;
+    using ApplyFunction = std::function<Image(const Image&)>;
+
+private:
+
+    enum class Operation
+    {
+        Load,
+        Input,
+        Resize,
+        Grayscale,
+        Lut,
+        Blur,
+        Draw,
+        Apply,
+        Save
+    };
+
+    struct Node
+    {
+        Operation operation;
+        NodeId input {-1};
+        std::string filename {};
+        int width {0};
+        int height {0};
+        int radius {0};
+        Lut table {};
+        DrawFunction drawFunction {};
+        ApplyFunction applyFunction {};
+        std::shared_ptr<const Image> image {};
+        bool kept {false};
+    };
+
+    struct Stage
+    {
+        NodeId head;
+        std::vector<NodeId> pointOperations;
+        NodeId last;
+        int dependency {-1};
+    };
+
+    std::vector<Node> mNodes {};
+    std::vector<std::shared_ptr<Image>> mResults {};
+
+public:
+
+    NodeId load(const std::string& filename);
+    NodeId input(const Image& image);
+    NodeId resize(NodeId node, int width, int height);
+    NodeId grayscale(NodeId node);
+    NodeId lut(NodeId node, const Lut& table);
+    NodeId blur(NodeId node, int radius);
+    NodeId draw(NodeId node, DrawFunction f);
+    NodeId apply(NodeId node, ApplyFunction f);
+    NodeId save(NodeId node, const std::string& filename);
+
+    void keep(NodeId node);
+    void run(int threads = 0);
+    const Image& result(NodeId node) const;
+
+private:
+
+    NodeId addNode(Node node);
+    bool isPointOperation(NodeId node) const;
+    std::vector<Stage> plan() const;
+    std::shared_ptr<Image> runHead(const Stage& stage, int threads);
+    std::shared_ptr<Image> runStage(const Stage& stage, int threads);
+    void applyPointOperations(Image& image, const std::vector<NodeId>& operations, int threads) const;
+};
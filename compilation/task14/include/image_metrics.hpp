@@ -0,0 +1,27 @@
+/*
+    Метрики качества изображения
+
+    Функции из этого файла сравнивают два изображения одинакового размера (например, оригинал и результат
+    сжатия через saveJpeg) и возвращают число - насколько они похожи.
+
+        mse(a, b)       -   среднеквадратичная ошибка по всем трём каналам (0 - изображения совпадают)
+        psnr(a, b)      -   пиковое отношение сигнал/шум в децибелах: 10 * log10(255^2 / mse).
+                            Для одинаковых изображений возвращает бесконечность.
+        ssim(a, b)      -   индекс структурного сходства (SSIM) по яркости, от -1 до 1 (1 - совпадают).
+                            Используется гауссово окно 11x11 с sigma = 1.5, как в оригинальной статье.
+        msSsim(a, b)    -   многомасштабный SSIM: SSIM считается на 5 масштабах (каждый следующий
+                            в 2 раза меньше) и результаты перемножаются со стандартными весами.
+
+    Локальные средние и дисперсии для SSIM считаются сепарабельным фильтром (сначала по строкам,
+    потом по столбцам). Изображение делится на полосы строк, каждая полоса обрабатывается своим потоком.
+    Параметр threads - число потоков (0 - по числу ядер процессора).
+*/
+
+#pragma once
+
+#include "image.hpp"
+
+double mse(const Image& a, const Image& b, int threads = 0);
+double psnr(const Image& a, const Image& b, int threads = 0);
+double ssim(const Image& a, const Image& b, int threads = 0);
+double msSsim(const Image& a, const Image& b, int threads = 0);
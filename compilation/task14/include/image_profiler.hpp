@@ -0,0 +1,127 @@
+/*
+    Замеры времени операций над изображениями
+
+    Если библиотеку собрать с флагом -DIMAGE_ENABLE_PROFILING, то загрузка, сохранение, рисование,
+    метрики, преобразования цвета и операции графа записывают в ImageProfiler, сколько раз они вызывались,
+    сколько времени заняли и сколько байт прочитали и записали.
+    Без этого флага макросы IMAGE_PROFILE и IMAGE_PROFILE_BYTES раскрываются в пустоту, их аргументы даже
+    не вычисляются, так что замеры ничего не стоят.
+
+    Время операции включает время вложенных в неё операций (например, load включает loadJpeg).
+
+    Использование внутри функции:
+
+        IMAGE_PROFILE(profile, "drawCircle");                       -   начать замер, он закончится в конце блока
+        IMAGE_PROFILE_BYTES(profile, bytesRead, bytesWritten);      -   добавить к замеру прочитанные/записанные байты
+
+    Методы класса ImageProfiler:
+
+        instance()                              -   единственный объект профилировщика
+        record(name, start, end, read, written) -   записать один вызов (обычно вызывается из Scope)
+        printSummary(std::ostream& out)         -   таблица: число вызовов, суммарное и среднее время,
+                                                    50, 95 и 99 перцентили, мегабайты чтения и записи
+        writeChromeTrace(const std::string& filename)
+                                                -   сохранить все вызовы в формате Chrome Trace (JSON),
+                                                    его можно открыть в chrome://tracing или ui.perfetto.dev
+        reset()                                 -   забыть всё записанное
+
+    Чтобы трасса не занимала бесконечно много памяти, в неё попадают только первые maxTraceEvents вызовов,
+    статистика же считается по всем. Длительности вызовов не хранятся: для перцентилей каждая операция
+    ведёт гистограмму с логарифмическими корзинами (8 корзин на каждую степень двойки наносекунд),
+    поэтому перцентили приблизительные, с точностью около 6%, а память не растёт с числом вызовов.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ImageProfiler
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t maxTraceEvents = 1000000;
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void addBytes(std::uint64_t bytesRead, std::uint64_t bytesWritten);
+
+    private:
+        ImageProfiler& mProfiler;
+        const char* mName;
+        Clock::time_point mStart;
+        std::uint64_t mBytesRead    {0};
+        std::uint64_t mBytesWritten {0};
+    };
+
+    static ImageProfiler& instance();
+
+    void record(const char* name, Clock::time_point start, Clock::time_point end,
+                std::uint64_t bytesRead, std::uint64_t bytesWritten);
+
+    void printSummary(std::ostream& out) const;
+    void writeChromeTrace(const std::string& filename) const;
+    void reset();
+
+private:
+
+    static constexpr int histogramSubBuckets = 8;
+    static constexpr int histogramBuckets = histogramSubBuckets * 62;
+
+    static int histogramBucket(std::int64_t duration);
+    static double histogramValue(int bucket);
+
+    struct OperationStats
+    {
+        std::uint64_t calls        {0};
+        std::uint64_t bytesRead    {0};
+        std::uint64_t bytesWritten {0};
+        std::int64_t totalDuration {0};
+        std::int64_t minDuration   {0};
+        std::int64_t maxDuration   {0};
+        std::array<std::uint64_t, histogramBuckets> histogram {};
+    };
+
+    struct TraceEvent
+    {
+        const char* name;
+        std::int64_t start;
+        std::int64_t duration;
+        int thread;
+        std::uint64_t bytesRead;
+        std::uint64_t bytesWritten;
+    };
+
+    ImageProfiler();
+    int threadIndex();
+
+    Clock::time_point mOrigin;
+    mutable std::mutex mMutex;
+    std::map<std::string, OperationStats> mStats {};
+    std::vector<TraceEvent> mTrace {};
+    std::map<std::size_t, int> mThreads {};
+};
+
+
+#ifdef IMAGE_ENABLE_PROFILING
+#define IMAGE_PROFILE(variable, name) ImageProfiler::Scope variable {name}
+#define IMAGE_PROFILE_BYTES(variable, bytesRead, bytesWritten) variable.addBytes((bytesRead), (bytesWritten))
+#else
+#define IMAGE_PROFILE(variable, name)
+#define IMAGE_PROFILE_BYTES(variable, bytesRead, bytesWritten)
+#endif
@@ -0,0 +1,50 @@
+/*
+    Простейший параллельный цикл
+
+    parallelFor(begin, end, threads, f) делит диапазон [begin, end) на threads непрерывных кусков
+    и вызывает f(from, to) для каждого куска в отдельном потоке std::thread.
+    Если threads <= 0, то используется std::thread::hardware_concurrency().
+    Первый кусок выполняется в вызывающем потоке, так что при threads == 1 новые потоки не создаются.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+inline int resolveThreadCount(int threads)
+{
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(threads, 1);
+}
+
+template <typename F>
+void parallelFor(int begin, int end, int threads, F&& f)
+{
+    int count = end - begin;
+    if (count <= 0)
+        return;
+
+    threads = std::min(resolveThreadCount(threads), count);
+    if (threads == 1)
+    {
+        f(begin, end);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t)
+    {
+        int from = begin + static_cast<int>(static_cast<long long>(count) * t / threads);
+        int to = begin + static_cast<int>(static_cast<long long>(count) * (t + 1) / threads);
+        workers.emplace_back([&f, from, to] { f(from, to); });
+    }
+
+    f(begin, begin + count / threads);
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
@@ -0,0 +1,94 @@
+/*
+    Планарное изображение
+
+    Класс PlanarImage хранит то же самое RGB изображение, что и Image, но в другом порядке:
+    вместо одного массива RGBRGBRGB... используются три отдельных массива (плоскости) RRR..., GGG... и BBB...
+    Каждая плоскость - это непрерывный одноканальный массив размера mWidth * mHeight, выровненный на 64 байта
+    (память берётся из ImageBufferPool). На таких данных поканальные алгоритмы (гистограммы, таблицы
+    преобразования, свёртки) векторизуются без перестановок байт.
+
+    Преобразование между чередующимся (Image) и планарным представлением происходит только на границах:
+    при загрузке (load), сохранении (save), а также в конструкторе PlanarImage(const Image&) и в toImage().
+    Рисование (fill, drawCircle, drawLine) работает напрямую с плоскостями.
+
+    Методы класса PlanarImage:
+
+        PlanarImage(const std::string& filename)    -   загрузить изображение из файла (любой формат, который
+                                                        поддерживает Image::load) и разложить по плоскостям
+        PlanarImage(const Image& image)             -   разложить изображение image по плоскостям
+        PlanarImage(int width, int height)          -   чёрное изображение размера width на height
+        PlanarImage(int width, int height, Color c) -   изображение размера width на height цвета c
+
+        getWidth, getHeight                         -   размеры изображения
+        getPlane(int channel)                       -   указатель на плоскость канала channel (0 - R, 1 - G, 2 - B)
+
+        setPixel, getPixel                          -   то же, что у Image
+        toImage()                                   -   собрать обычное (чередующееся) изображение
+
+        load, save                                  -   загрузка и сохранение через Image::load и Image::save
+
+        fill(Color c)                               -   залить всё изображение цветом c
+        drawCircle, drawLine                        -   то же, что у Image
+
+    Статические функции deinterleave и interleave - быстрые (SSSE3, если процессор его поддерживает)
+    преобразования count пикселей между массивом RGBRGB... и тремя плоскостями.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "image.hpp"
+#include "image_buffer_pool.hpp"
+
+class PlanarImage
+{
+public:
+
+    using Plane = std::vector<unsigned char, ImageBufferPool::Allocator<unsigned char>>;
+    using Color = Image::Color;
+
+private:
+
+    int mWidth  {0};
+    int mHeight {0};
+    Plane mPlanes[3] {};
+
+public:
+
+    PlanarImage();
+    PlanarImage(const std::string& filename);
+    explicit PlanarImage(const Image& image);
+    PlanarImage(int width, int height);
+    PlanarImage(int width, int height, Color c);
+
+    int getWidth() const;
+    int getHeight() const;
+    unsigned char* getPlane(int channel);
+    const unsigned char* getPlane(int channel) const;
+
+    void setPixel(int i, int j, Color c);
+    Color getPixel(int i, int j) const;
+
+    void fromImage(const Image& image);
+    Image toImage() const;
+
+    void load(const std::string& filename);
+    void save(const std::string& filename) const;
+
+    void fill(Color c);
+    void drawCircle(int radius, int centerX, int centerY, Color c);
+    void drawLine(int x1, int y1, int x2, int y2, Color c);
+
+    static void deinterleave(const unsigned char* rgb, unsigned char* r, unsigned char* g, unsigned char* b,
+                             std::size_t count);
+    static void interleave(const unsigned char* r, const unsigned char* g, const unsigned char* b,
+                           unsigned char* rgb, std::size_t count);
+
+private:
+
+    void resize(int width, int height);
+    void fillSpan(int j, int iBegin, int iEnd, Color c);
+};
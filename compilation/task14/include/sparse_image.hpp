@@ -0,0 +1,81 @@
+/*
+    Разреженное изображение (слой)
+
+    Класс SparseImage хранит слой, на котором нарисовано немного линий и фигур на пустом (прозрачном) фоне.
+    Вместо плотного массива 3 * mWidth * mHeight байт каждая строка хранится как отсортированный список
+    отрезков одного цвета (RLE): начало, длина и цвет. Пустые места не хранятся совсем, поэтому память
+    и время наложения зависят от того, сколько нарисовано, а не от площади слоя.
+
+    Методы класса SparseImage:
+
+        SparseImage(int width, int height)              -   пустой слой размера width на height
+        SparseImage(const Image& image, Color background)
+                                                        -   слой из изображения: все пиксели цвета background
+                                                            считаются пустыми
+
+        getWidth, getHeight                             -   размеры слоя
+        getRow(int j)                                   -   отрезки строки j
+        getRunCount()                                   -   общее число отрезков
+        getMemoryUsage()                                -   сколько байт занимают отрезки
+
+        setPixel(int i, int j, Color c)                 -   закрасить пиксель
+        getPixel(int i, int j, Color& c)                -   возвращает false, если пиксель пустой
+        fillSpan(int j, int iBegin, int iEnd, Color c)  -   закрасить пиксели [iBegin, iEnd) строки j
+        clear()                                         -   сделать слой пустым
+
+        drawCircle, drawLine                            -   то же, что у Image, но рисуют прямо в отрезки
+                                                            (круг - по одному отрезку на строку)
+
+        blitTo(Image& dst, int x, int y)                -   наложить слой на dst так, чтобы левый верхний угол
+                                                            слоя попал в пиксель (x, y). Записываются только
+                                                            непустые отрезки, пустые места не просматриваются.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "image.hpp"
+
+class SparseImage
+{
+public:
+
+    using Color = Image::Color;
+
+    struct Run
+    {
+        int start;
+        int length;
+        Color color;
+    };
+
+private:
+
+    int mWidth  {0};
+    int mHeight {0};
+    std::vector<std::vector<Run>> mRows {};
+
+public:
+
+    SparseImage();
+    SparseImage(int width, int height);
+    SparseImage(const Image& image, Color background);
+
+    int getWidth() const;
+    int getHeight() const;
+    const std::vector<Run>& getRow(int j) const;
+    std::size_t getRunCount() const;
+    std::size_t getMemoryUsage() const;
+
+    void setPixel(int i, int j, Color c);
+    bool getPixel(int i, int j, Color& c) const;
+    void fillSpan(int j, int iBegin, int iEnd, Color c);
+    void clear();
+
+    void drawCircle(int radius, int centerX, int centerY, Color c);
+    void drawLine(int x1, int y1, int x2, int y2, Color c);
+
+    void blitTo(Image& dst, int x = 0, int y = 0) const;
+};
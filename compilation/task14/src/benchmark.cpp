@@ -0,0 +1,268 @@
+/*
+    Бенчмарки библиотеки image
+
+    Запуск:
+        image_bench [--sizes 1,4,16] [--out results.csv] [--baseline old.csv] [--threshold 10]
+
+    --sizes      -  размеры синтетических изображений в мегапикселях (по умолчанию 1,4,16; можно до 100)
+    --out        -  куда записать результаты в формате CSV: name,megapixels,ns_per_pixel,mb_per_s
+    --baseline   -  CSV от предыдущего запуска. Для каждого замера печатается изменение относительно него,
+                    а если что-то стало медленнее больше чем на threshold процентов, программа вернёт код 1.
+    --threshold  -  допустимое замедление в процентах (по умолчанию 10)
+
+    Каждый замер повторяется, пока не наберётся хотя бы 0.2 секунды и 3 повтора; берётся лучшее время.
+    MB/s считается по размеру RGB данных изображения (3 байта на пиксель).
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "image.hpp"
+
+
+struct Result
+{
+    std::string name;
+    double megapixels;
+    double nsPerPixel;
+    double mbPerSecond;
+};
+
+static volatile unsigned sink = 0;
+
+static double measureSeconds(const std::function<void()>& f)
+{
+    using Clock = std::chrono::steady_clock;
+
+    double best = 1e100;
+    double total = 0;
+    int repeats = 0;
+    while (repeats < 3 || total < 0.2)
+    {
+        Clock::time_point start = Clock::now();
+        f();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = std::min(best, seconds);
+        total += seconds;
+        repeats++;
+    }
+    return best;
+}
+
+static Image syntheticImage(int width, int height)
+{
+    // Плавный градиент с небольшим шумом - JPEG на таком сжимается примерно как на фотографии
+    Image result(width, height);
+    unsigned seed = 12345;
+    for (int j = 0; j < height; ++j)
+    {
+        for (int i = 0; i < width; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            int noise = static_cast<int>((seed >> 16) & 15) - 8;
+            result.setPixel(i, j, {static_cast<unsigned char>(std::clamp(255 * i / width + noise, 0, 255)),
+                                   static_cast<unsigned char>(std::clamp(255 * j / height + noise, 0, 255)),
+                                   static_cast<unsigned char>(std::clamp(128 + noise, 0, 255))});
+        }
+    }
+    return result;
+}
+
+static std::map<std::string, double> readBaseline(const std::string& filename)
+{
+    std::map<std::string, double> result;
+    std::ifstream in {filename};
+    if (in.fail())
+    {
+        std::cout << "Error. Can't open baseline file!" << std::endl;
+        std::exit(1);
+    }
+
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line))
+    {
+        std::stringstream fields {line};
+        std::string name, megapixels, nsPerPixel;
+        std::getline(fields, name, ',');
+        std::getline(fields, megapixels, ',');
+        std::getline(fields, nsPerPixel, ',');
+        if (!nsPerPixel.empty())
+            result[name + "@" + megapixels] = std::stod(nsPerPixel);
+    }
+    return result;
+}
+
+static std::string formatMegapixels(double megapixels)
+{
+    std::ostringstream out;
+    out << megapixels;
+    return out.str();
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<double> sizes {1, 4, 16};
+    std::string outFilename;
+    std::string baselineFilename;
+    double threshold = 10;
+
+    for (int k = 1; k < argc; k += 2)
+    {
+        std::string option = argv[k];
+        if (k + 1 == argc)
+        {
+            std::cout << "Error. Option " << option << " needs a value!" << std::endl;
+            return 1;
+        }
+        std::string value = argv[k + 1];
+        if (option == "--sizes")
+        {
+            sizes.clear();
+            std::stringstream list {value};
+            std::string item;
+            while (std::getline(list, item, ','))
+                sizes.push_back(std::stod(item));
+        }
+        else if (option == "--out")
+            outFilename = value;
+        else if (option == "--baseline")
+            baselineFilename = value;
+        else if (option == "--threshold")
+            threshold = std::stod(value);
+        else
+        {
+            std::cout << "Error. Unknown option " << option << "!" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    auto report = [&results](const std::string& name, double megapixels, double pixels, double seconds)
+    {
+        results.push_back({name, megapixels, seconds * 1e9 / pixels, 3 * pixels / seconds / 1e6});
+        const Result& r = results.back();
+        std::cout << std::left << std::setw(24) << name << std::right << std::setw(8) << megapixels << " MP"
+                  << std::fixed << std::setprecision(3) << std::setw(12) << r.nsPerPixel << " ns/pixel"
+                  << std::setprecision(1) << std::setw(12) << r.mbPerSecond << " MB/s" << std::defaultfloat
+                  << std::endl;
+    };
+
+    for (double megapixels : sizes)
+    {
+        // Изображения с соотношением сторон 4:3
+        int width = static_cast<int>(std::sqrt(megapixels * 1e6 * 4 / 3));
+        int height = static_cast<int>(megapixels * 1e6 / width);
+        double pixels = static_cast<double>(width) * height;
+
+        Image image = syntheticImage(width, height);
+
+        report("setPixel", megapixels, pixels, measureSeconds([&]
+        {
+            for (int j = 0; j < height; ++j)
+                for (int i = 0; i < width; ++i)
+                    image.setPixel(i, j, {static_cast<unsigned char>(i), static_cast<unsigned char>(j), 7});
+        }));
+
+        report("getPixel", megapixels, pixels, measureSeconds([&]
+        {
+            unsigned sum = 0;
+            for (int j = 0; j < height; ++j)
+                for (int i = 0; i < width; ++i)
+                    sum += image.getPixel(i, j).g;
+            sink = sink + sum;
+        }));
+
+        report("fillConstructor", megapixels, pixels, measureSeconds([&]
+        {
+            Image filled(width, height, {10, 20, 30});
+            sink = sink + filled.getData()[0];
+        }));
+
+        // Круги разного радиуса: от маленьких до вписанного в изображение. Считаем на пиксель круга.
+        for (int divisor : {64, 8, 2})
+        {
+            int radius = std::min(width, height) / divisor;
+            double area = 3.14159265358979 * radius * radius;
+            report("drawCircle r=1/" + std::to_string(divisor), megapixels, area, measureSeconds([&]
+            {
+                image.drawCircle(radius, width / 2, height / 2, {255, 0, 0});
+            }));
+        }
+
+        // Пологие линии разной длины, считаем на пиксель линии: в линии max(|dx|, |dy|) + 1 пикселей
+        for (int divisor : {64, 8, 1})
+        {
+            int dx = width / divisor - 1;
+            int dy = std::max(0, std::min(dx / 2, height - 17));
+            report("drawLine l=1/" + std::to_string(divisor), megapixels, std::max(dx, dy) + 1, measureSeconds([&]
+            {
+                for (int k = 0; k < 16; ++k)
+                    image.drawLine(0, k, dx, k + dy, {0, 255, 0});
+            }) / 16);
+        }
+
+        std::string ppmName = "bench_" + formatMegapixels(megapixels) + ".ppm";
+        std::string jpegName = "bench_" + formatMegapixels(megapixels) + ".jpg";
+
+        report("savePpm", megapixels, pixels, measureSeconds([&] { image.savePpm(ppmName); }));
+        report("loadPpm", megapixels, pixels, measureSeconds([&]
+        {
+            Image loaded;
+            loaded.loadPpm(ppmName);
+            sink = sink + loaded.getData()[0];
+        }));
+
+        report("saveJpeg", megapixels, pixels, measureSeconds([&] { image.saveJpeg(jpegName); }));
+        report("loadJpeg", megapixels, pixels, measureSeconds([&]
+        {
+            Image loaded;
+            loaded.loadJpeg(jpegName);
+            sink = sink + loaded.getData()[0];
+        }));
+
+        std::remove(ppmName.c_str());
+        std::remove(jpegName.c_str());
+    }
+
+    if (!outFilename.empty())
+    {
+        std::ofstream out {outFilename};
+        out << "name,megapixels,ns_per_pixel,mb_per_s\n";
+        for (const Result& r : results)
+            out << r.name << "," << r.megapixels << "," << r.nsPerPixel << "," << r.mbPerSecond << "\n";
+    }
+
+    if (baselineFilename.empty())
+        return 0;
+
+    std::map<std::string, double> baseline = readBaseline(baselineFilename);
+    bool regression = false;
+
+    std::cout << "\nComparison with " << baselineFilename << " (positive - slower):" << std::endl;
+    for (const Result& r : results)
+    {
+        auto it = baseline.find(r.name + "@" + formatMegapixels(r.megapixels));
+        if (it == baseline.end())
+            continue;
+
+        double change = 100 * (r.nsPerPixel / it->second - 1);
+        bool slower = change > threshold;
+        regression = regression || slower;
+
+        std::cout << std::left << std::setw(24) << r.name << std::right << std::setw(8) << r.megapixels << " MP"
+                  << std::showpos << std::fixed << std::setprecision(1) << std::setw(10) << change << " %"
+                  << std::noshowpos << std::defaultfloat << (slower ? "   REGRESSION" : "") << std::endl;
+    }
+    return regression ? 1 : 0;
+}
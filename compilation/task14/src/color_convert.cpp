@@ -0,0 +1,444 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#define COLOR_CONVERT_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "color_convert.hpp"
+#include "planar_image.hpp"
+#include "parallel_for.hpp"
+#include "image_profiler.hpp"
+
+
+// Коэффициенты RGB -> YCbCr в формате Q8 (умножены на 256). В каждой строке сумма равна 256 для Y и 0 для Cb, Cr,
+// поэтому серый цвет переходит в (Y, 128, 128) без ошибки округления.
+struct ForwardCoefficients
+{
+    short yr, yg, yb;
+    short cbr, cbg, cbb;
+    short crr, crg, crb;
+};
+
+// Коэффициенты YCbCr -> RGB в формате Q14.
+struct InverseCoefficients
+{
+    short crToR;
+    short cbToG;
+    short crToG;
+    short cbToB;
+};
+
+static const ForwardCoefficients forward601 {77, 150, 29, -43, -85, 128, 128, -107, -21};
+static const ForwardCoefficients forward709 {54, 183, 19, -29, -99, 128, 128, -116, -12};
+
+static const InverseCoefficients inverse601 {22970, 5638, 11700, 29032};
+static const InverseCoefficients inverse709 {25801, 3069, 7669, 30402};
+
+static const int chromaOffset = 128 * 256 + 127;
+
+static const ForwardCoefficients& forwardCoefficients(YCbCrStandard standard)
+{
+    return standard == YCbCrStandard::Bt709 ? forward709 : forward601;
+}
+
+static const InverseCoefficients& inverseCoefficients(YCbCrStandard standard)
+{
+    return standard == YCbCrStandard::Bt709 ? inverse709 : inverse601;
+}
+
+static unsigned char clampByte(int value)
+{
+    return static_cast<unsigned char>(std::clamp(value, 0, 255));
+}
+
+
+// Применяет kernel к каждой строке изображения, разложенной на плоскости, и собирает результат обратно.
+// kernel(r, g, b, outR, outG, outB, count)
+template <typename Kernel>
+static Image convertRows(const Image& image, int threads, Kernel kernel)
+{
+    int width = image.getWidth();
+    Image result(width, image.getHeight());
+    const unsigned char* src = image.getData();
+    unsigned char* dst = result.getData();
+
+    parallelFor(0, image.getHeight(), threads, [&](int from, int to)
+    {
+        std::vector<unsigned char> in(3 * width);
+        std::vector<unsigned char> out(3 * width);
+        unsigned char* inPlanes[3] = {in.data(), in.data() + width, in.data() + 2 * width};
+        unsigned char* outPlanes[3] = {out.data(), out.data() + width, out.data() + 2 * width};
+
+        for (int j = from; j < to; ++j)
+        {
+            std::size_t offset = 3 * static_cast<std::size_t>(j) * width;
+            PlanarImage::deinterleave(src + offset, inPlanes[0], inPlanes[1], inPlanes[2], width);
+            kernel(inPlanes[0], inPlanes[1], inPlanes[2], outPlanes[0], outPlanes[1], outPlanes[2], width);
+            PlanarImage::interleave(outPlanes[0], outPlanes[1], outPlanes[2], dst + offset, width);
+        }
+    });
+    return result;
+}
+
+#ifdef COLOR_CONVERT_HAS_SSE2
+
+// (r * cr + g * cg + b * cb + offset) >> 8 для 16 пикселей. Все промежуточные суммы считаются по модулю 2^16,
+// а итоговое значение до сдвига всегда лежит в 0..65535, поэтому переполнения не влияют на результат.
+static __m128i weightedSumQ8(__m128i r, __m128i g, __m128i b, short cr, short cg, short cb, short offset)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i halves[2];
+    for (int h = 0; h < 2; ++h)
+    {
+        __m128i r16 = h == 0 ? _mm_unpacklo_epi8(r, zero) : _mm_unpackhi_epi8(r, zero);
+        __m128i g16 = h == 0 ? _mm_unpacklo_epi8(g, zero) : _mm_unpackhi_epi8(g, zero);
+        __m128i b16 = h == 0 ? _mm_unpacklo_epi8(b, zero) : _mm_unpackhi_epi8(b, zero);
+
+        __m128i sum = _mm_set1_epi16(offset);
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(r16, _mm_set1_epi16(cr)));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(g16, _mm_set1_epi16(cg)));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(b16, _mm_set1_epi16(cb)));
+        halves[h] = _mm_srli_epi16(sum, 8);
+    }
+    return _mm_packus_epi16(halves[0], halves[1]);
+}
+
+// y + ((a * ka + b * kb + 2^13) >> 14) для 8 пикселей, a и b - знаковые 16-битные значения.
+static __m128i addScaledQ14(__m128i y16, __m128i a, __m128i b, short ka, short kb)
+{
+    __m128i k = _mm_set_epi16(kb, ka, kb, ka, kb, ka, kb, ka);
+    __m128i rounding = _mm_set1_epi32(1 << 13);
+    __m128i lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), k), rounding), 14);
+    __m128i hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), k), rounding), 14);
+    return _mm_add_epi16(y16, _mm_packs_epi32(lo, hi));
+}
+
+#endif
+
+static void forwardKernel(const ForwardCoefficients& k, const unsigned char* r, const unsigned char* g,
+                          const unsigned char* b, unsigned char* y, unsigned char* cb, unsigned char* cr, int count)
+{
+    int n = 0;
+#ifdef COLOR_CONVERT_HAS_SSE2
+    for (; n + 16 <= count; n += 16)
+    {
+        __m128i vr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + n));
+        __m128i vg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + n));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + n), weightedSumQ8(vr, vg, vb, k.yr, k.yg, k.yb, 128));
+        if (cb != nullptr)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cb + n),
+                             weightedSumQ8(vr, vg, vb, k.cbr, k.cbg, k.cbb, static_cast<short>(chromaOffset)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cr + n),
+                             weightedSumQ8(vr, vg, vb, k.crr, k.crg, k.crb, static_cast<short>(chromaOffset)));
+        }
+    }
+#endif
+    for (; n < count; ++n)
+    {
+        y[n] = static_cast<unsigned char>((k.yr * r[n] + k.yg * g[n] + k.yb * b[n] + 128) >> 8);
+        if (cb != nullptr)
+        {
+            cb[n] = static_cast<unsigned char>((k.cbr * r[n] + k.cbg * g[n] + k.cbb * b[n] + chromaOffset) >> 8);
+            cr[n] = static_cast<unsigned char>((k.crr * r[n] + k.crg * g[n] + k.crb * b[n] + chromaOffset) >> 8);
+        }
+    }
+}
+
+static void inverseKernel(const InverseCoefficients& k, const unsigned char* y, const unsigned char* cb,
+                          const unsigned char* cr, unsigned char* r, unsigned char* g, unsigned char* b, int count)
+{
+    int n = 0;
+#ifdef COLOR_CONVERT_HAS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i one = _mm_set1_epi16(1);
+    __m128i bias = _mm_set1_epi16(128);
+    for (; n + 16 <= count; n += 16)
+    {
+        __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + n));
+        __m128i vcb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cb + n));
+        __m128i vcr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cr + n));
+
+        __m128i out[3][2];
+        for (int h = 0; h < 2; ++h)
+        {
+            __m128i y16 = h == 0 ? _mm_unpacklo_epi8(vy, zero) : _mm_unpackhi_epi8(vy, zero);
+            __m128i cb16 = _mm_sub_epi16(h == 0 ? _mm_unpacklo_epi8(vcb, zero) : _mm_unpackhi_epi8(vcb, zero), bias);
+            __m128i cr16 = _mm_sub_epi16(h == 0 ? _mm_unpacklo_epi8(vcr, zero) : _mm_unpackhi_epi8(vcr, zero), bias);
+
+            // Слагаемое с единицей и нулевым коэффициентом нужно только чтобы использовать одно и то же
+            // попарное умножение _mm_madd_epi16 для всех трёх каналов.
+            out[0][h] = addScaledQ14(y16, cr16, one, k.crToR, 0);
+            out[1][h] = addScaledQ14(y16, cb16, cr16, static_cast<short>(-k.cbToG), static_cast<short>(-k.crToG));
+            out[2][h] = addScaledQ14(y16, cb16, one, k.cbToB, 0);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + n), _mm_packus_epi16(out[0][0], out[0][1]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(g + n), _mm_packus_epi16(out[1][0], out[1][1]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b + n), _mm_packus_epi16(out[2][0], out[2][1]));
+    }
+#endif
+    for (; n < count; ++n)
+    {
+        int cbValue = cb[n] - 128;
+        int crValue = cr[n] - 128;
+        r[n] = clampByte(y[n] + ((crValue * k.crToR + (1 << 13)) >> 14));
+        g[n] = clampByte(y[n] + ((-cbValue * k.cbToG - crValue * k.crToG + (1 << 13)) >> 14));
+        b[n] = clampByte(y[n] + ((cbValue * k.cbToB + (1 << 13)) >> 14));
+    }
+}
+
+
+Image rgbToYCbCr(const Image& image, YCbCrStandard standard, int threads)
+{
+    IMAGE_PROFILE(profile, "rgbToYCbCr");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight(),
+                        3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight());
+    const ForwardCoefficients& k = forwardCoefficients(standard);
+    return convertRows(image, threads, [&k](const unsigned char* r, const unsigned char* g, const unsigned char* b,
+                                            unsigned char* y, unsigned char* cb, unsigned char* cr, int count)
+    {
+        forwardKernel(k, r, g, b, y, cb, cr, count);
+    });
+}
+
+Image yCbCrToRgb(const Image& image, YCbCrStandard standard, int threads)
+{
+    IMAGE_PROFILE(profile, "yCbCrToRgb");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight(),
+                        3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight());
+    const InverseCoefficients& k = inverseCoefficients(standard);
+    return convertRows(image, threads, [&k](const unsigned char* y, const unsigned char* cb, const unsigned char* cr,
+                                            unsigned char* r, unsigned char* g, unsigned char* b, int count)
+    {
+        inverseKernel(k, y, cb, cr, r, g, b, count);
+    });
+}
+
+std::vector<unsigned char> toGrayscale(const Image& image, YCbCrStandard standard, int threads)
+{
+    IMAGE_PROFILE(profile, "toGrayscale");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight(),
+                        3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight() / 3);
+    const ForwardCoefficients& k = forwardCoefficients(standard);
+    int width = image.getWidth();
+    std::vector<unsigned char> result(static_cast<std::size_t>(width) * image.getHeight());
+    const unsigned char* src = image.getData();
+
+    parallelFor(0, image.getHeight(), threads, [&](int from, int to)
+    {
+        std::vector<unsigned char> planes(3 * width);
+        unsigned char* r = planes.data();
+        unsigned char* g = r + width;
+        unsigned char* b = g + width;
+        for (int j = from; j < to; ++j)
+        {
+            std::size_t offset = static_cast<std::size_t>(j) * width;
+            PlanarImage::deinterleave(src + 3 * offset, r, g, b, width);
+            forwardKernel(k, r, g, b, result.data() + offset, nullptr, nullptr, width);
+        }
+    });
+    return result;
+}
+
+Image rgbToHsv(const Image& image, int threads)
+{
+    IMAGE_PROFILE(profile, "rgbToHsv");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight(),
+                        3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight());
+    return convertRows(image, threads, [](const unsigned char* r, const unsigned char* g, const unsigned char* b,
+                                          unsigned char* h, unsigned char* s, unsigned char* v, int count)
+    {
+        for (int n = 0; n < count; ++n)
+        {
+            int maxValue = std::max({r[n], g[n], b[n]});
+            int minValue = std::min({r[n], g[n], b[n]});
+            int delta = maxValue - minValue;
+
+            v[n] = static_cast<unsigned char>(maxValue);
+            s[n] = maxValue == 0 ? 0 : static_cast<unsigned char>((255 * delta + maxValue / 2) / maxValue);
+
+            if (delta == 0)
+            {
+                h[n] = 0;
+                continue;
+            }
+
+            // Полный круг тона - 256 единиц, на каждый из шести секторов приходится 256 / 6.
+            // Числитель умножен на 6 * delta, к нему добавлен полный круг, чтобы он стал неотрицательным.
+            int numerator;
+            if (maxValue == r[n])
+                numerator = 256 * (g[n] - b[n]);
+            else if (maxValue == g[n])
+                numerator = 512 * delta + 256 * (b[n] - r[n]);
+            else
+                numerator = 1024 * delta + 256 * (r[n] - g[n]);
+
+            h[n] = static_cast<unsigned char>(((numerator + 1536 * delta + 3 * delta) / (6 * delta)) & 255);
+        }
+    });
+}
+
+Image hsvToRgb(const Image& image, int threads)
+{
+    IMAGE_PROFILE(profile, "hsvToRgb");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight(),
+                        3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight());
+    return convertRows(image, threads, [](const unsigned char* h, const unsigned char* s, const unsigned char* v,
+                                          unsigned char* r, unsigned char* g, unsigned char* b, int count)
+    {
+        for (int n = 0; n < count; ++n)
+        {
+            float hue = h[n] * (6.0f / 256.0f);
+            float saturation = s[n] / 255.0f;
+            float value = v[n];
+
+            int sector = static_cast<int>(hue);
+            float fraction = hue - sector;
+            float p = value * (1 - saturation);
+            float q = value * (1 - saturation * fraction);
+            float t = value * (1 - saturation * (1 - fraction));
+
+            float rgb[3];
+            switch (sector)
+            {
+                case 0:  rgb[0] = value; rgb[1] = t;     rgb[2] = p;     break;
+                case 1:  rgb[0] = q;     rgb[1] = value; rgb[2] = p;     break;
+                case 2:  rgb[0] = p;     rgb[1] = value; rgb[2] = t;     break;
+                case 3:  rgb[0] = p;     rgb[1] = q;     rgb[2] = value; break;
+                case 4:  rgb[0] = t;     rgb[1] = p;     rgb[2] = value; break;
+                default: rgb[0] = value; rgb[1] = p;     rgb[2] = q;     break;
+            }
+
+            r[n] = clampByte(static_cast<int>(rgb[0] + 0.5f));
+            g[n] = clampByte(static_cast<int>(rgb[1] + 0.5f));
+            b[n] = clampByte(static_cast<int>(rgb[2] + 0.5f));
+        }
+    });
+}
+
+
+static const float* srgbToLinearTable()
+{
+    static const std::vector<float> table = []
+    {
+        std::vector<float> result(256);
+        for (int i = 0; i < 256; ++i)
+        {
+            double c = i / 255.0;
+            result[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+        }
+        return result;
+    }();
+    return table.data();
+}
+
+static unsigned char linearToSrgb(float c)
+{
+    c = std::clamp(c, 0.0f, 1.0f);
+    float encoded = c <= 0.0031308f ? 12.92f * c : 1.055f * std::pow(c, 1 / 2.4f) - 0.055f;
+    return clampByte(static_cast<int>(255 * encoded + 0.5f));
+}
+
+static const float whiteX = 0.95047f;
+static const float whiteZ = 1.08883f;
+static const float labEpsilon = 216.0f / 24389.0f;
+static const float labKappa = 24389.0f / 27.0f;
+
+static float labF(float t)
+{
+    return t > labEpsilon ? std::cbrt(t) : (labKappa * t + 16) / 116;
+}
+
+static float labFInverse(float f)
+{
+    float cube = f * f * f;
+    return cube > labEpsilon ? cube : (116 * f - 16) / labKappa;
+}
+
+std::vector<float> toLinear(const Image& image, int threads)
+{
+    IMAGE_PROFILE(profile, "toLinear");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight(),
+                        4 * 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight());
+    const float* table = srgbToLinearTable();
+    const unsigned char* src = image.getData();
+    std::size_t rowValues = 3 * static_cast<std::size_t>(image.getWidth());
+    std::vector<float> result(rowValues * image.getHeight());
+
+    parallelFor(0, image.getHeight(), threads, [&](int from, int to)
+    {
+        for (std::size_t n = from * rowValues; n < to * rowValues; ++n)
+            result[n] = table[src[n]];
+    });
+    return result;
+}
+
+std::vector<float> rgbToLab(const Image& image, int threads)
+{
+    IMAGE_PROFILE(profile, "rgbToLab");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight(),
+                        4 * 3 * static_cast<std::uint64_t>(image.getWidth()) * image.getHeight());
+    const float* table = srgbToLinearTable();
+    const unsigned char* src = image.getData();
+    std::size_t width = image.getWidth();
+    std::vector<float> result(3 * width * image.getHeight());
+
+    parallelFor(0, image.getHeight(), threads, [&](int from, int to)
+    {
+        for (std::size_t n = from * width; n < to * width; ++n)
+        {
+            float r = table[src[3 * n]];
+            float g = table[src[3 * n + 1]];
+            float b = table[src[3 * n + 2]];
+
+            float fx = labF((0.4124564f * r + 0.3575761f * g + 0.1804375f * b) / whiteX);
+            float fy = labF(0.2126729f * r + 0.7151522f * g + 0.0721750f * b);
+            float fz = labF((0.0193339f * r + 0.1191920f * g + 0.9503041f * b) / whiteZ);
+
+            result[3 * n] = 116 * fy - 16;
+            result[3 * n + 1] = 500 * (fx - fy);
+            result[3 * n + 2] = 200 * (fy - fz);
+        }
+    });
+    return result;
+}
+
+Image labToRgb(const std::vector<float>& lab, int width, int height, int threads)
+{
+    IMAGE_PROFILE(profile, "labToRgb");
+    IMAGE_PROFILE_BYTES(profile, 4 * lab.size(), lab.size());
+    if (lab.size() != 3 * static_cast<std::size_t>(width) * height)
+    {
+        std::cout << "Error. Lab data size doesn't match image size!" << std::endl;
+        std::exit(1);
+    }
+
+    Image result(width, height);
+    unsigned char* dst = result.getData();
+
+    parallelFor(0, height, threads, [&](int from, int to)
+    {
+        for (std::size_t n = from * static_cast<std::size_t>(width); n < to * static_cast<std::size_t>(width); ++n)
+        {
+            float fy = (lab[3 * n] + 16) / 116;
+            float fx = fy + lab[3 * n + 1] / 500;
+            float fz = fy - lab[3 * n + 2] / 200;
+
+            float x = whiteX * labFInverse(fx);
+            float y = labFInverse(fy);
+            float z = whiteZ * labFInverse(fz);
+
+            dst[3 * n] = linearToSrgb(3.2404542f * x - 1.5371385f * y - 0.4985314f * z);
+            dst[3 * n + 1] = linearToSrgb(-0.9692660f * x + 1.8760108f * y + 0.0415560f * z);
+            dst[3 * n + 2] = linearToSrgb(0.0556434f * x - 0.2040259f * y + 1.0572252f * z);
+        }
+    });
+    return result;
+}
@@ -5,6 +5,18 @@
 #include <cmath>
 #include <cassert>
 #include <cstring>
+#include <cerrno>
+#include <cctype>
+#include <iterator>
+#include <filesystem>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define IMAGE_HAS_WRITEV
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -13,6 +25,8 @@
 #include <stb_image_write.h>
 
 #include "image.hpp"
+#include "parallel_for.hpp"
+#include "image_profiler.hpp"
 
 
 Image::Color& Image::Color::operator+=(Color c) 
@@ -66,6 +80,11 @@ Image::Image(int width, int height, Color c) : mWidth(width), mHeight(height)
     }
 }
 
+Image::Image(int width, int height, ImageBufferPool& pool) : mWidth(width), mHeight(height), mData(pool)
+{
+    mData.resize(3 * mWidth * mHeight);
+}
+
 int Image::getWidth() const 
 {
     return mWidth;
@@ -81,6 +100,11 @@ unsigned char* Image::getData()
     return mData.data();
 }
 
+const unsigned char* Image::getData() const
+{
+    return mData.data();
+}
+
 void Image::setPixel(int i, int j, Color c)
 {
     assert(i >= 0 && i < mWidth && j >= 0 && j < mHeight);
@@ -100,6 +124,7 @@ Image::Color Image::getPixel(int i, int j) const
 
 void Image::load(const std::string& filename)
 {
+    IMAGE_PROFILE(profile, "load");
     if (filename.ends_with(".ppm"))
     {
         loadPpm(filename);
@@ -108,6 +133,19 @@ void Image::load(const std::string& filename)
     {
         loadJpeg(filename);
     }
+    else if (filename.ends_with(".png") || filename.ends_with(".bmp") ||
+             filename.ends_with(".tga") || filename.ends_with(".pgm"))
+    {
+        std::ifstream in {filename, std::ios::binary};
+        if (in.fail())
+        {
+            std::cout << "Error. Can't open file!" << std::endl;
+            std::exit(1);
+        }
+
+        std::vector<char> bytes {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        loadFromMemory(std::as_bytes(std::span<const char>(bytes)));
+    }
     else
     {
         std::cout << "Error. File format not supported!" << std::endl;
@@ -115,8 +153,128 @@ void Image::load(const std::string& filename)
     }
 }
 
+Image::Format Image::detectFormat(std::span<const std::byte> bytes)
+{
+    auto startsWith = [bytes](std::initializer_list<unsigned char> magic)
+    {
+        if (bytes.size() < magic.size())
+            return false;
+        return std::equal(magic.begin(), magic.end(), bytes.begin(),
+                          [](unsigned char m, std::byte b) { return std::byte {m} == b; });
+    };
+
+    if (startsWith({'P', '6'}))
+        return Format::Ppm;
+    if (startsWith({'P', '5'}))
+        return Format::Pgm;
+    if (startsWith({0xFF, 0xD8, 0xFF}))
+        return Format::Jpeg;
+    if (startsWith({0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'}))
+        return Format::Png;
+    if (startsWith({'B', 'M'}))
+        return Format::Bmp;
+    return Format::Unknown;
+}
+
+void Image::loadFromMemory(std::span<const std::byte> bytes)
+{
+    IMAGE_PROFILE(profile, "loadFromMemory");
+    IMAGE_PROFILE_BYTES(profile, bytes.size(), 0);
+    if (detectFormat(bytes) == Format::Ppm && loadPpmFromMemory(bytes))
+        return;
+
+    loadWithStb(bytes);
+}
+
+// Разбор P6 прямо из памяти. Возвращает false, если заголовок нестандартный (например, maxValue > 255),
+// тогда картинку декодирует stb_image.
+bool Image::loadPpmFromMemory(std::span<const std::byte> bytes)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes.data());
+    const unsigned char* end = p + bytes.size();
+    p += 2;
+
+    auto readNumber = [&p, end](int& value)
+    {
+        while (p < end && (std::isspace(*p) || *p == '#'))
+        {
+            if (*p == '#')
+            {
+                while (p < end && *p != '\n')
+                    p++;
+            }
+            else
+            {
+                p++;
+            }
+        }
+
+        if (p == end || !std::isdigit(*p))
+            return false;
+
+        value = 0;
+        while (p < end && std::isdigit(*p))
+        {
+            value = 10 * value + (*p++ - '0');
+            if (value >= 1000000)
+                return false;
+        }
+        return true;
+    };
+
+    int width = 0;
+    int height = 0;
+    int maxValue = 0;
+    if (!readNumber(width) || !readNumber(height) || !readNumber(maxValue))
+        return false;
+    if (maxValue != 255 || p == end || !std::isspace(*p))
+        return false;
+    p++;
+
+    std::size_t size = 3 * static_cast<std::size_t>(width) * height;
+    if (static_cast<std::size_t>(end - p) < size)
+    {
+        std::cout << "Error. PPM data is truncated!" << std::endl;
+        std::exit(1);
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mData.resize(size);
+    if (size > 0)
+        std::memcpy(mData.data(), p, size);
+    return true;
+}
+
+void Image::loadWithStb(std::span<const std::byte> bytes)
+{
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    if (bytes.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    {
+        std::cout << "Error. Image data is too large to decode!" << std::endl;
+        std::exit(1);
+    }
+    unsigned char* stbiData = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(bytes.data()),
+                                                    static_cast<int>(bytes.size()),
+                                                    &width, &height, &channels, 3);
+    if (stbiData == nullptr)
+    {
+        std::cout << "Error. Can't decode image: " << stbi_failure_reason() << "!" << std::endl;
+        std::exit(1);
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mData.resize(3 * static_cast<std::size_t>(mWidth) * mHeight);
+    std::memcpy(mData.data(), stbiData, mData.size());
+    stbi_image_free(stbiData);
+}
+
 void Image::save(const std::string& filename) const
 {
+    IMAGE_PROFILE(profile, "save");
     if (filename.ends_with(".ppm"))
     {
         savePpm(filename);
@@ -134,6 +292,7 @@ void Image::save(const std::string& filename) const
 
 void Image::loadPpm(const std::string& filename)
 {
+    IMAGE_PROFILE(profile, "loadPpm");
     std::ifstream in {filename, std::ios::binary};
     if (in.fail())
     {
@@ -159,18 +318,90 @@ void Image::loadPpm(const std::string& filename)
 
     mData.resize(3 * mWidth * mHeight);
     in.read(reinterpret_cast<char*>(&mData[0]), mData.size());
+    IMAGE_PROFILE_BYTES(profile, mData.size(), mData.size());
+}
+
+std::string Image::ppmHeader() const
+{
+    return "P6\n" + std::to_string(mWidth) + " " + std::to_string(mHeight) + "\n255\n";
 }
 
 void Image::savePpm(const std::string& filename) const
 {
+    IMAGE_PROFILE(profile, "savePpm");
+    IMAGE_PROFILE_BYTES(profile, mData.size(), mData.size());
+    std::string header = ppmHeader();
+
+#ifdef IMAGE_HAS_WRITEV
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cout << "Error. Can't open file!" << std::endl;
+        std::exit(1);
+    }
+
+    iovec parts[2];
+    parts[0].iov_base = header.data();
+    parts[0].iov_len = header.size();
+    parts[1].iov_base = const_cast<unsigned char*>(mData.data());
+    parts[1].iov_len = mData.size();
+
+    iovec* current = parts;
+    int count = mData.empty() ? 1 : 2;
+    while (count > 0)
+    {
+        ssize_t written = writev(fd, current, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cout << "Error. Can't write file!" << std::endl;
+            std::exit(1);
+        }
+
+        // writev может записать не всё: пропускаем полностью записанные части и сдвигаем начало текущей
+        std::size_t rest = static_cast<std::size_t>(written);
+        while (count > 0 && rest >= current->iov_len)
+        {
+            rest -= current->iov_len;
+            current++;
+            count--;
+        }
+        if (count > 0)
+        {
+            current->iov_base = static_cast<char*>(current->iov_base) + rest;
+            current->iov_len -= rest;
+        }
+    }
+    close(fd);
+#else
     std::ofstream out {filename, std::ios::binary};
-    out << "P6\n" << mWidth << " " << mHeight << "\n255\n";
-    out.write(reinterpret_cast<const char*>(&mData[0]), mData.size());
+    if (out.fail())
+    {
+        std::cout << "Error. Can't open file!" << std::endl;
+        std::exit(1);
+    }
+    out.write(header.data(), header.size());
+    out.write(reinterpret_cast<const char*>(mData.data()), mData.size());
+#endif
+}
+
+std::vector<unsigned char> Image::encodePpm() const
+{
+    IMAGE_PROFILE(profile, "encodePpm");
+    IMAGE_PROFILE_BYTES(profile, mData.size(), mData.size());
+    std::string header = ppmHeader();
+    std::vector<unsigned char> result(header.size() + mData.size());
+    std::memcpy(result.data(), header.data(), header.size());
+    if (!mData.empty())
+        std::memcpy(result.data() + header.size(), mData.data(), mData.size());
+    return result;
 }
 
 
 void Image::loadJpeg(const std::string& filename)
 {
+    IMAGE_PROFILE(profile, "loadJpeg");
     int width = 0;
     int height = 0;
     int channels = 0;
@@ -192,17 +423,96 @@ void Image::loadJpeg(const std::string& filename)
     mData.resize(3 * mWidth * mHeight);
     std::memcpy(mData.data(), stbiData, 3 * mWidth * mHeight);
     stbi_image_free(stbiData);
+    IMAGE_PROFILE_BYTES(profile, std::filesystem::file_size(filename), mData.size());
+}
+
+int Image::effectiveQuality(const JpegOptions& options)
+{
+    int quality = std::clamp(options.quality, 1, 100);
+    if (options.subsampling == ChromaSubsampling::Yuv420)
+        quality = std::min(quality, 90);
+    else if (options.subsampling == ChromaSubsampling::Yuv444)
+        quality = std::max(quality, 91);
+    return quality;
 }
 
 void Image::saveJpeg(const std::string& filename) const
 {
-    stbi_write_jpg(filename.c_str(), mWidth, mHeight, 3, mData.data(), 90);
+    saveJpeg(filename, JpegOptions {});
+}
+
+void Image::saveJpeg(const std::string& filename, const JpegOptions& options) const
+{
+    IMAGE_PROFILE(profile, "saveJpeg");
+    IMAGE_PROFILE_BYTES(profile, mData.size(), 0);
+    if (!stbi_write_jpg(filename.c_str(), mWidth, mHeight, 3, mData.data(), effectiveQuality(options)))
+    {
+        std::cout << "Error. Can't write file!" << std::endl;
+        std::exit(1);
+    }
+}
+
+void Image::writeJpeg(const WriteCallback& write) const
+{
+    writeJpeg(write, JpegOptions {});
+}
+
+void Image::writeJpeg(const WriteCallback& write, const JpegOptions& options) const
+{
+    IMAGE_PROFILE(profile, "writeJpeg");
+    IMAGE_PROFILE_BYTES(profile, mData.size(), 0);
+    auto callback = [](void* context, void* data, int size)
+    {
+        (*static_cast<const WriteCallback*>(context))(data, size);
+    };
+
+    if (!stbi_write_jpg_to_func(callback, const_cast<WriteCallback*>(&write), mWidth, mHeight, 3, mData.data(),
+                                effectiveQuality(options)))
+    {
+        std::cout << "Error. Can't write file!" << std::endl;
+        std::exit(1);
+    }
+}
+
+std::vector<unsigned char> Image::encodeJpeg() const
+{
+    return encodeJpeg(JpegOptions {});
+}
+
+std::vector<unsigned char> Image::encodeJpeg(const JpegOptions& options) const
+{
+    std::vector<unsigned char> result;
+    result.reserve(mData.size() / 8);
+    writeJpeg([&result](const void* data, int size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        result.insert(result.end(), bytes, bytes + size);
+    }, options);
+    return result;
+}
+
+std::vector<std::vector<unsigned char>> Image::encodeJpegBatch(const std::vector<const Image*>& images)
+{
+    return encodeJpegBatch(images, JpegOptions {}, 0);
+}
+
+std::vector<std::vector<unsigned char>> Image::encodeJpegBatch(const std::vector<const Image*>& images,
+                                                               const JpegOptions& options, int threads)
+{
+    std::vector<std::vector<unsigned char>> result(images.size());
+    parallelFor(0, static_cast<int>(images.size()), threads, [&](int from, int to)
+    {
+        for (int k = from; k < to; ++k)
+            result[k] = images[k]->encodeJpeg(options);
+    });
+    return result;
 }
 
 
 
 void Image::drawCircle(int radius, int centerX, int centerY, Color c)
 {
+    IMAGE_PROFILE(profile, "drawCircle");
     for (int j = std::max(centerY - radius, 0); j <std:: min(centerY + radius, mHeight); j++)
     {
         for (int i = std::max(centerX - radius, 0); i < std::min(centerX + radius, mWidth); i++)
@@ -215,6 +525,7 @@ void Image::drawCircle(int radius, int centerX, int centerY, Color c)
 
 void Image::drawLine(int x1, int y1, int x2, int y2, Color c)
 {
+    IMAGE_PROFILE(profile, "drawLine");
     bool steep = (std::fabs(y2 - y1) > std::fabs(x2 - x1));
     if(steep)
     {
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <cstdlib>
+#include <bit>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "image_buffer_pool.hpp"
+
+
+ImageBufferPool::ImageBufferPool(bool useHugePages, std::size_t maxCachedBytes)
+    : mUseHugePages(useHugePages), mMaxCachedBytes(maxCachedBytes)
+{
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+    trim();
+}
+
+std::size_t ImageBufferPool::bucketSize(std::size_t size)
+{
+    if (size <= 4 * alignment)
+        return (size + alignment - 1) / alignment * alignment;
+
+    std::size_t step = std::bit_floor(size - 1) / 4;
+    return (size + step - 1) / step * step;
+}
+
+std::size_t ImageBufferPool::allocationSize(std::size_t bucket) const
+{
+    if (mUseHugePages && bucket >= hugePageSize)
+        return (bucket + hugePageSize - 1) / hugePageSize * hugePageSize;
+    return bucket;
+}
+
+void* ImageBufferPool::allocateBlock(std::size_t bucket)
+{
+    std::size_t size = allocationSize(bucket);
+    std::size_t align = (size != bucket) ? hugePageSize : alignment;
+
+#if defined(_WIN32)
+    void* p = _aligned_malloc(size, align);
+#else
+    void* p = std::aligned_alloc(align, size);
+#endif
+    if (p == nullptr)
+    {
+        std::cout << "Error. Memory allocation failed!" << std::endl;
+        std::exit(1);
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (align == hugePageSize)
+        madvise(p, size, MADV_HUGEPAGE);
+#endif
+    return p;
+}
+
+void ImageBufferPool::freeBlock(void* p)
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* ImageBufferPool::allocate(std::size_t size)
+{
+    if (size == 0)
+        size = 1;
+    std::size_t bucket = bucketSize(size);
+
+    {
+        std::lock_guard<std::mutex> lock {mMutex};
+        auto it = mFreeLists.find(bucket);
+        if (it != mFreeLists.end() && !it->second.empty())
+        {
+            void* p = it->second.back();
+            it->second.pop_back();
+            mStats.hits += 1;
+            mStats.cachedBytes -= bucket;
+            return p;
+        }
+        mStats.misses += 1;
+    }
+
+    return allocateBlock(bucket);
+}
+
+void ImageBufferPool::deallocate(void* p, std::size_t size)
+{
+    if (p == nullptr)
+        return;
+    if (size == 0)
+        size = 1;
+    std::size_t bucket = bucketSize(size);
+
+    {
+        std::lock_guard<std::mutex> lock {mMutex};
+        mStats.releases += 1;
+        if (mStats.cachedBytes + bucket <= mMaxCachedBytes)
+        {
+            mFreeLists[bucket].push_back(p);
+            mStats.cachedBytes += bucket;
+            return;
+        }
+    }
+
+    freeBlock(p);
+}
+
+void ImageBufferPool::trim()
+{
+    std::lock_guard<std::mutex> lock {mMutex};
+    for (auto& [bucket, blocks] : mFreeLists)
+    {
+        for (void* p : blocks)
+            freeBlock(p);
+    }
+    mFreeLists.clear();
+    mStats.cachedBytes = 0;
+}
+
+ImageBufferPool::Stats ImageBufferPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock {mMutex};
+    return mStats;
+}
+
+void ImageBufferPool::resetStats()
+{
+    std::lock_guard<std::mutex> lock {mMutex};
+    mStats.hits = 0;
+    mStats.misses = 0;
+    mStats.releases = 0;
+}
+
+void ImageBufferPool::printStats() const
+{
+    Stats s = getStats();
+    std::cout << "ImageBufferPool: hits = " << s.hits
+              << ", misses = " << s.misses
+              << ", releases = " << s.releases
+              << ", cached = " << s.cachedBytes << " bytes" << std::endl;
+}
+
+ImageBufferPool& ImageBufferPool::global()
+{
+    static ImageBufferPool pool;
+    return pool;
+}
@@ -0,0 +1,467 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+#include "image_graph.hpp"
+#include "parallel_for.hpp"
+#include "image_profiler.hpp"
+
+
+#ifdef IMAGE_ENABLE_PROFILING
+static const char* const operationNames[] = {"graph load", "graph input", "graph resize", "graph grayscale",
+                                             "graph lut", "graph blur", "graph draw", "graph apply", "graph save"};
+#endif
+
+// Полоса строк, которая проходит через все поточечные операции стадии за один раз
+static const std::size_t stripBytes = 64 * 1024;
+
+static Image resizeBilinear(const Image& src, int width, int height, int threads)
+{
+    Image result(width, height);
+    int srcWidth = src.getWidth();
+    int srcHeight = src.getHeight();
+    if (srcWidth == 0 || srcHeight == 0)
+        return result;
+
+    const unsigned char* in = src.getData();
+    unsigned char* out = result.getData();
+
+    // Для каждого столбца результата заранее считаем два соседних столбца источника и вес правого
+    std::vector<int> x0(width);
+    std::vector<int> x1(width);
+    std::vector<float> wx(width);
+    for (int i = 0; i < width; ++i)
+    {
+        float x = std::clamp((i + 0.5f) * srcWidth / width - 0.5f, 0.0f, static_cast<float>(srcWidth - 1));
+        x0[i] = static_cast<int>(x);
+        x1[i] = std::min(x0[i] + 1, srcWidth - 1);
+        wx[i] = x - x0[i];
+    }
+
+    parallelFor(0, height, threads, [&](int from, int to)
+    {
+        for (int j = from; j < to; ++j)
+        {
+            float y = std::clamp((j + 0.5f) * srcHeight / height - 0.5f, 0.0f, static_cast<float>(srcHeight - 1));
+            int y0 = static_cast<int>(y);
+            int y1 = std::min(y0 + 1, srcHeight - 1);
+            float wy = y - y0;
+
+            const unsigned char* top = in + 3 * static_cast<std::size_t>(y0) * srcWidth;
+            const unsigned char* bottom = in + 3 * static_cast<std::size_t>(y1) * srcWidth;
+            unsigned char* row = out + 3 * static_cast<std::size_t>(j) * width;
+
+            for (int i = 0; i < width; ++i)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    float t = top[3 * x0[i] + c] + wx[i] * (top[3 * x1[i] + c] - top[3 * x0[i] + c]);
+                    float b = bottom[3 * x0[i] + c] + wx[i] * (bottom[3 * x1[i] + c] - bottom[3 * x0[i] + c]);
+                    row[3 * i + c] = static_cast<unsigned char>(t + wy * (b - t) + 0.5f);
+                }
+            }
+        }
+    });
+    return result;
+}
+
+static Image boxBlur(const Image& src, int radius, int threads)
+{
+    int width = src.getWidth();
+    int height = src.getHeight();
+    Image horizontal(width, height);
+    Image result(width, height);
+    if (width == 0 || height == 0)
+        return result;
+
+    int window = 2 * radius + 1;
+    const unsigned char* in = src.getData();
+    unsigned char* mid = horizontal.getData();
+    unsigned char* out = result.getData();
+
+    // Проход по строкам: скользящая сумма окна, за краем изображения повторяется крайний пиксель
+    parallelFor(0, height, threads, [&](int from, int to)
+    {
+        for (int j = from; j < to; ++j)
+        {
+            const unsigned char* row = in + 3 * static_cast<std::size_t>(j) * width;
+            unsigned char* dst = mid + 3 * static_cast<std::size_t>(j) * width;
+            for (int c = 0; c < 3; ++c)
+            {
+                int sum = 0;
+                for (int k = -radius; k <= radius; ++k)
+                    sum += row[3 * std::clamp(k, 0, width - 1) + c];
+
+                for (int i = 0; i < width; ++i)
+                {
+                    dst[3 * i + c] = static_cast<unsigned char>((sum + window / 2) / window);
+                    sum += row[3 * std::min(i + radius + 1, width - 1) + c];
+                    sum -= row[3 * std::max(i - radius, 0) + c];
+                }
+            }
+        }
+    });
+
+    // Проход по столбцам: каждый поток ведёт скользящие суммы для своей группы столбцов, двигаясь вниз
+    std::size_t rowValues = 3 * static_cast<std::size_t>(width);
+    parallelFor(0, width, threads, [&](int from, int to)
+    {
+        std::size_t begin = 3 * static_cast<std::size_t>(from);
+        std::size_t end = 3 * static_cast<std::size_t>(to);
+        std::vector<int> sums(end - begin, 0);
+
+        for (int k = -radius; k <= radius; ++k)
+        {
+            const unsigned char* row = mid + std::clamp(k, 0, height - 1) * rowValues;
+            for (std::size_t n = begin; n < end; ++n)
+                sums[n - begin] += row[n];
+        }
+
+        for (int j = 0; j < height; ++j)
+        {
+            unsigned char* dst = out + j * rowValues;
+            const unsigned char* added = mid + std::min(j + radius + 1, height - 1) * rowValues;
+            const unsigned char* removed = mid + std::max(j - radius, 0) * rowValues;
+            for (std::size_t n = begin; n < end; ++n)
+            {
+                dst[n] = static_cast<unsigned char>((sums[n - begin] + window / 2) / window);
+                sums[n - begin] += added[n] - removed[n];
+            }
+        }
+    });
+    return result;
+}
+
+
+ImageGraph::NodeId ImageGraph::addNode(Node node)
+{
+    bool isSource = node.operation == Operation::Load || node.operation == Operation::Input;
+    if (node.input >= static_cast<int>(mNodes.size()) || (!isSource && node.input < 0))
+    {
+        std::cout << "Error. Unknown graph node!" << std::endl;
+        std::exit(1);
+    }
+
+    mNodes.push_back(std::move(node));
+    return static_cast<NodeId>(mNodes.size() - 1);
+}
+
+ImageGraph::NodeId ImageGraph::load(const std::string& filename)
+{
+    Node node {Operation::Load};
+    node.filename = filename;
+    return addNode(std::move(node));
+}
+
+ImageGraph::NodeId ImageGraph::input(const Image& image)
+{
+    Node node {Operation::Input};
+    node.image = std::make_shared<const Image>(image);
+    return addNode(std::move(node));
+}
+
+ImageGraph::NodeId ImageGraph::resize(NodeId node, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        std::cout << "Error. Wrong image size!" << std::endl;
+        std::exit(1);
+    }
+
+    Node result {Operation::Resize, node};
+    result.width = width;
+    result.height = height;
+    return addNode(std::move(result));
+}
+
+ImageGraph::NodeId ImageGraph::grayscale(NodeId node)
+{
+    return addNode({Operation::Grayscale, node});
+}
+
+ImageGraph::NodeId ImageGraph::lut(NodeId node, const Lut& table)
+{
+    Node result {Operation::Lut, node};
+    result.table = table;
+    return addNode(std::move(result));
+}
+
+ImageGraph::NodeId ImageGraph::blur(NodeId node, int radius)
+{
+    Node result {Operation::Blur, node};
+    result.radius = std::max(radius, 0);
+    return addNode(std::move(result));
+}
+
+ImageGraph::NodeId ImageGraph::draw(NodeId node, DrawFunction f)
+{
+    Node result {Operation::Draw, node};
+    result.drawFunction = std::move(f);
+    return addNode(std::move(result));
+}
+
+ImageGraph::NodeId ImageGraph::apply(NodeId node, ApplyFunction f)
+{
+    Node result {Operation::Apply, node};
+    result.applyFunction = std::move(f);
+    return addNode(std::move(result));
+}
+
+ImageGraph::NodeId ImageGraph::save(NodeId node, const std::string& filename)
+{
+    Node result {Operation::Save, node};
+    result.filename = filename;
+    return addNode(std::move(result));
+}
+
+void ImageGraph::keep(NodeId node)
+{
+    mNodes.at(node).kept = true;
+}
+
+bool ImageGraph::isPointOperation(NodeId node) const
+{
+    Operation operation = mNodes[node].operation;
+    return operation == Operation::Grayscale || operation == Operation::Lut;
+}
+
+std::vector<ImageGraph::Stage> ImageGraph::plan() const
+{
+    int count = static_cast<int>(mNodes.size());
+
+    // Сколько раз нужен результат каждого узла: другими узлами и пользователем (keep)
+    std::vector<int> consumers(count, 0);
+    std::vector<NodeId> onlyConsumer(count, -1);
+    for (NodeId n = 0; n < count; ++n)
+    {
+        if (mNodes[n].kept)
+            consumers[n] += 1;
+        if (mNodes[n].input >= 0)
+        {
+            consumers[mNodes[n].input] += 1;
+            onlyConsumer[mNodes[n].input] = n;
+        }
+    }
+
+    // Поточечная операция сливается с предыдущей стадией, если больше никому не нужен её вход
+    auto fused = [&](NodeId n)
+    {
+        return isPointOperation(n) && consumers[mNodes[n].input] == 1;
+    };
+
+    std::vector<Stage> stages;
+    std::vector<int> stageOf(count, -1);
+    for (NodeId n = 0; n < count; ++n)
+    {
+        if (fused(n))
+            continue;
+
+        Stage stage {n, {}, n};
+        if (isPointOperation(n))
+            stage.pointOperations.push_back(n);
+
+        while (consumers[stage.last] == 1 && onlyConsumer[stage.last] >= 0 && fused(onlyConsumer[stage.last]))
+        {
+            stage.last = onlyConsumer[stage.last];
+            stage.pointOperations.push_back(stage.last);
+        }
+
+        if (mNodes[n].input >= 0)
+            stage.dependency = stageOf[mNodes[n].input];
+
+        stageOf[stage.last] = static_cast<int>(stages.size());
+        stages.push_back(std::move(stage));
+    }
+    return stages;
+}
+
+void ImageGraph::applyPointOperations(Image& image, const std::vector<NodeId>& operations, int threads) const
+{
+    using RowFunction = std::function<void(unsigned char* data, std::size_t pixels)>;
+    std::vector<RowFunction> functions;
+
+    for (std::size_t k = 0; k < operations.size(); ++k)
+    {
+        const Node& node = mNodes[operations[k]];
+        if (node.operation == Operation::Lut)
+        {
+            // Несколько таблиц подряд - это одна таблица
+            Lut table = node.table;
+            while (k + 1 < operations.size() && mNodes[operations[k + 1]].operation == Operation::Lut)
+            {
+                const Lut& next = mNodes[operations[++k]].table;
+                for (unsigned char& value : table)
+                    value = next[value];
+            }
+
+            functions.push_back([table](unsigned char* data, std::size_t pixels)
+            {
+                for (std::size_t n = 0; n < 3 * pixels; ++n)
+                    data[n] = table[data[n]];
+            });
+        }
+        else if (node.operation == Operation::Grayscale)
+        {
+            functions.push_back([](unsigned char* data, std::size_t pixels)
+            {
+                for (std::size_t n = 0; n < pixels; ++n)
+                {
+                    unsigned char* p = data + 3 * n;
+                    unsigned char y = static_cast<unsigned char>((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+                    p[0] = y;
+                    p[1] = y;
+                    p[2] = y;
+                }
+            });
+        }
+    }
+
+    int width = image.getWidth();
+    if (width == 0 || functions.empty())
+        return;
+
+    IMAGE_PROFILE(profile, "graph point operations");
+    IMAGE_PROFILE_BYTES(profile, 3 * static_cast<std::uint64_t>(width) * image.getHeight(),
+                        3 * static_cast<std::uint64_t>(width) * image.getHeight());
+
+    int stripRows = std::max<int>(1, static_cast<int>(stripBytes / (3 * static_cast<std::size_t>(width))));
+    unsigned char* data = image.getData();
+
+    parallelFor(0, image.getHeight(), threads, [&](int from, int to)
+    {
+        for (int j = from; j < to; j += stripRows)
+        {
+            int rows = std::min(stripRows, to - j);
+            unsigned char* strip = data + 3 * static_cast<std::size_t>(j) * width;
+            for (const RowFunction& f : functions)
+                f(strip, static_cast<std::size_t>(rows) * width);
+        }
+    });
+}
+
+std::shared_ptr<Image> ImageGraph::runHead(const Stage& stage, int threads)
+{
+    const Node& head = mNodes[stage.head];
+    IMAGE_PROFILE(profile, operationNames[static_cast<int>(head.operation)]);
+
+    std::shared_ptr<const Image> input;
+    if (head.input >= 0)
+        input = mResults[head.input];
+
+    std::shared_ptr<Image> image;
+    switch (head.operation)
+    {
+        case Operation::Load:
+            image = std::make_shared<Image>(head.filename);
+            break;
+        case Operation::Input:
+            image = std::make_shared<Image>(*head.image);
+            break;
+        case Operation::Resize:
+            image = std::make_shared<Image>(resizeBilinear(*input, head.width, head.height, threads));
+            break;
+        case Operation::Blur:
+            image = std::make_shared<Image>(boxBlur(*input, head.radius, threads));
+            break;
+        case Operation::Draw:
+            image = std::make_shared<Image>(*input);
+            head.drawFunction(*image);
+            break;
+        case Operation::Apply:
+            image = std::make_shared<Image>(head.applyFunction(*input));
+            break;
+        case Operation::Save:
+            input->save(head.filename);
+            // Save не меняет изображение, поэтому отдаёт дальше тот же объект.
+            // Копия нужна, только если за ним идут поточечные операции, которые изменят его на месте.
+            if (stage.pointOperations.empty())
+                image = std::const_pointer_cast<Image>(input);
+            else
+                image = std::make_shared<Image>(*input);
+            break;
+        case Operation::Grayscale:
+        case Operation::Lut:
+            image = std::make_shared<Image>(*input);
+            break;
+    }
+
+    IMAGE_PROFILE_BYTES(profile, input ? 3 * static_cast<std::uint64_t>(input->getWidth()) * input->getHeight() : 0,
+                        3 * static_cast<std::uint64_t>(image->getWidth()) * image->getHeight());
+    return image;
+}
+
+std::shared_ptr<Image> ImageGraph::runStage(const Stage& stage, int threads)
+{
+    std::shared_ptr<Image> image = runHead(stage, threads);
+    applyPointOperations(*image, stage.pointOperations, threads);
+    return image;
+}
+
+void ImageGraph::run(int threads)
+{
+    mResults.assign(mNodes.size(), nullptr);
+    threads = resolveThreadCount(threads);
+    std::vector<Stage> stages = plan();
+    std::vector<bool> done(stages.size(), false);
+
+    // Выполняем волнами: в каждой волне параллельно все стадии, входы которых уже готовы
+    std::size_t remaining = stages.size();
+    while (remaining > 0)
+    {
+        std::vector<std::size_t> ready;
+        for (std::size_t s = 0; s < stages.size(); ++s)
+        {
+            if (!done[s] && (stages[s].dependency < 0 || done[stages[s].dependency]))
+                ready.push_back(s);
+        }
+
+        // Потоки делятся между одновременно идущими стадиями, чтобы не перегружать процессор
+        int count = static_cast<int>(ready.size());
+        auto share = [threads, count](std::size_t k)
+        {
+            int k32 = static_cast<int>(k);
+            return std::max(1, threads * (k32 + 1) / count - threads * k32 / count);
+        };
+
+        std::vector<std::future<std::shared_ptr<Image>>> futures;
+        for (std::size_t k = 1; k < ready.size(); ++k)
+            futures.push_back(std::async(std::launch::async, [this, &stages, &ready, k, threads = share(k)]
+            {
+                return runStage(stages[ready[k]], threads);
+            }));
+
+        std::shared_ptr<Image> first = runStage(stages[ready[0]], share(0));
+        mResults[stages[ready[0]].last] = first;
+        for (std::size_t k = 1; k < ready.size(); ++k)
+            mResults[stages[ready[k]].last] = futures[k - 1].get();
+
+        for (std::size_t s : ready)
+            done[s] = true;
+        remaining -= ready.size();
+    }
+
+    // Оставляем только результаты, которые попросили через keep, и конечные узлы графа
+    std::vector<bool> hasConsumers(mNodes.size(), false);
+    for (const Node& node : mNodes)
+    {
+        if (node.input >= 0)
+            hasConsumers[node.input] = true;
+    }
+    for (std::size_t n = 0; n < mNodes.size(); ++n)
+    {
+        if (!mNodes[n].kept && hasConsumers[n])
+            mResults[n] = nullptr;
+    }
+}
+
+const Image& ImageGraph::result(NodeId node) const
+{
+    if (node < 0 || node >= static_cast<int>(mResults.size()) || mResults[node] == nullptr)
+    {
+        std::cout << "Error. Result of graph node " << node << " is not available (use keep)!" << std::endl;
+        std::exit(1);
+    }
+    return *mResults[node];
+}
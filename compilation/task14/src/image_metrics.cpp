@@ -0,0 +1,279 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+#include "image_metrics.hpp"
+#include "parallel_for.hpp"
+#include "image_profiler.hpp"
+
+
+struct LumaPlane
+{
+    int width  {0};
+    int height {0};
+    std::vector<float> data {};
+};
+
+struct SsimResult
+{
+    double ssim {0};
+    double cs   {0};
+};
+
+static const int ssimRadius = 5;
+static const double ssimSigma = 1.5;
+static const int ssimBlockRows = 64;
+
+static void checkSizes(const Image& a, const Image& b)
+{
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight())
+    {
+        std::cout << "Error. Images should have the same size!" << std::endl;
+        std::exit(1);
+    }
+}
+
+static LumaPlane luma(const Image& image, int threads)
+{
+    LumaPlane result;
+    result.width = image.getWidth();
+    result.height = image.getHeight();
+    result.data.resize(static_cast<std::size_t>(result.width) * result.height);
+
+    const unsigned char* rgb = image.getData();
+    parallelFor(0, result.height, threads, [&](int from, int to)
+    {
+        std::size_t begin = static_cast<std::size_t>(from) * result.width;
+        std::size_t end = static_cast<std::size_t>(to) * result.width;
+        for (std::size_t n = begin; n < end; ++n)
+            result.data[n] = 0.299f * rgb[3 * n] + 0.587f * rgb[3 * n + 1] + 0.114f * rgb[3 * n + 2];
+    });
+    return result;
+}
+
+static LumaPlane downsample(const LumaPlane& plane)
+{
+    LumaPlane result;
+    result.width = plane.width / 2;
+    result.height = plane.height / 2;
+    result.data.resize(static_cast<std::size_t>(result.width) * result.height);
+
+    for (int j = 0; j < result.height; ++j)
+    {
+        const float* top = &plane.data[static_cast<std::size_t>(2 * j) * plane.width];
+        const float* bottom = top + plane.width;
+        float* out = &result.data[static_cast<std::size_t>(j) * result.width];
+        for (int i = 0; i < result.width; ++i)
+            out[i] = 0.25f * (top[2 * i] + top[2 * i + 1] + bottom[2 * i] + bottom[2 * i + 1]);
+    }
+    return result;
+}
+
+static std::vector<float> gaussianKernel(int radius)
+{
+    std::vector<float> kernel(2 * radius + 1);
+    double sum = 0;
+    for (int k = -radius; k <= radius; ++k)
+    {
+        double value = std::exp(-(k * k) / (2 * ssimSigma * ssimSigma));
+        kernel[k + radius] = static_cast<float>(value);
+        sum += value;
+    }
+    for (float& value : kernel)
+        value = static_cast<float>(value / sum);
+    return kernel;
+}
+
+// Средние значения SSIM и его множителя contrast-structure (cs) по всем положениям окна,
+// которые целиком помещаются в изображение.
+static SsimResult ssimStats(const LumaPlane& x, const LumaPlane& y, int threads)
+{
+    const double c1 = (0.01 * 255) * (0.01 * 255);
+    const double c2 = (0.03 * 255) * (0.03 * 255);
+
+    int radius = std::min(ssimRadius, (std::min(x.width, x.height) - 1) / 2);
+    int size = 2 * radius + 1;
+    int outWidth = x.width - 2 * radius;
+    int outHeight = x.height - 2 * radius;
+    std::vector<float> kernel = gaussianKernel(radius);
+
+    std::mutex mutex;
+    SsimResult total;
+
+    parallelFor(0, outHeight, threads, [&](int from, int to)
+    {
+        // Горизонтальный проход пишет 5 величин (x, y, x^2, y^2, xy) для строк блока вместе с "полями"
+        // по вертикали, затем вертикальный проход сворачивает их в итоговые локальные моменты.
+        std::vector<float> rows[5];
+        for (std::vector<float>& row : rows)
+            row.resize(static_cast<std::size_t>(ssimBlockRows + size - 1) * outWidth);
+
+        double sumSsim = 0;
+        double sumCs = 0;
+
+        for (int blockBegin = from; blockBegin < to; blockBegin += ssimBlockRows)
+        {
+            int blockEnd = std::min(blockBegin + ssimBlockRows, to);
+            int inputRows = blockEnd - blockBegin + size - 1;
+
+            for (int r = 0; r < inputRows; ++r)
+            {
+                std::size_t inOffset = static_cast<std::size_t>(blockBegin + r) * x.width;
+                const float* px = &x.data[inOffset];
+                const float* py = &y.data[inOffset];
+                std::size_t outOffset = static_cast<std::size_t>(r) * outWidth;
+
+                for (int i = 0; i < outWidth; ++i)
+                {
+                    float mx = 0, my = 0, mxx = 0, myy = 0, mxy = 0;
+                    for (int k = 0; k < size; ++k)
+                    {
+                        float a = px[i + k];
+                        float b = py[i + k];
+                        float w = kernel[k];
+                        mx += w * a;
+                        my += w * b;
+                        mxx += w * a * a;
+                        myy += w * b * b;
+                        mxy += w * a * b;
+                    }
+                    rows[0][outOffset + i] = mx;
+                    rows[1][outOffset + i] = my;
+                    rows[2][outOffset + i] = mxx;
+                    rows[3][outOffset + i] = myy;
+                    rows[4][outOffset + i] = mxy;
+                }
+            }
+
+            for (int r = 0; r < blockEnd - blockBegin; ++r)
+            {
+                for (int i = 0; i < outWidth; ++i)
+                {
+                    double m[5] = {0, 0, 0, 0, 0};
+                    for (int k = 0; k < size; ++k)
+                    {
+                        std::size_t index = static_cast<std::size_t>(r + k) * outWidth + i;
+                        for (int q = 0; q < 5; ++q)
+                            m[q] += kernel[k] * rows[q][index];
+                    }
+
+                    double varX = m[2] - m[0] * m[0];
+                    double varY = m[3] - m[1] * m[1];
+                    double covXY = m[4] - m[0] * m[1];
+
+                    double cs = (2 * covXY + c2) / (varX + varY + c2);
+                    double l = (2 * m[0] * m[1] + c1) / (m[0] * m[0] + m[1] * m[1] + c1);
+                    sumSsim += l * cs;
+                    sumCs += cs;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock {mutex};
+        total.ssim += sumSsim;
+        total.cs += sumCs;
+    });
+
+    double count = static_cast<double>(outWidth) * outHeight;
+    total.ssim /= count;
+    total.cs /= count;
+    return total;
+}
+
+
+double mse(const Image& a, const Image& b, int threads)
+{
+    IMAGE_PROFILE(profile, "mse");
+    IMAGE_PROFILE_BYTES(profile, 6 * static_cast<std::uint64_t>(a.getWidth()) * a.getHeight(), 0);
+    checkSizes(a, b);
+    if (a.getWidth() == 0 || a.getHeight() == 0)
+        return 0;
+
+    const unsigned char* pa = a.getData();
+    const unsigned char* pb = b.getData();
+    std::size_t rowBytes = 3 * static_cast<std::size_t>(a.getWidth());
+
+    std::mutex mutex;
+    std::uint64_t total = 0;
+
+    parallelFor(0, a.getHeight(), threads, [&](int from, int to)
+    {
+        std::uint64_t sum = 0;
+        for (std::size_t n = from * rowBytes; n < to * rowBytes; ++n)
+        {
+            int d = pa[n] - pb[n];
+            sum += static_cast<std::uint32_t>(d * d);
+        }
+
+        std::lock_guard<std::mutex> lock {mutex};
+        total += sum;
+    });
+
+    return static_cast<double>(total) / (rowBytes * a.getHeight());
+}
+
+double psnr(const Image& a, const Image& b, int threads)
+{
+    double error = mse(a, b, threads);
+    if (error == 0)
+        return std::numeric_limits<double>::infinity();
+    return 10 * std::log10(255.0 * 255.0 / error);
+}
+
+double ssim(const Image& a, const Image& b, int threads)
+{
+    IMAGE_PROFILE(profile, "ssim");
+    IMAGE_PROFILE_BYTES(profile, 6 * static_cast<std::uint64_t>(a.getWidth()) * a.getHeight(), 0);
+    checkSizes(a, b);
+    if (a.getWidth() == 0 || a.getHeight() == 0)
+        return 1;
+
+    return ssimStats(luma(a, threads), luma(b, threads), threads).ssim;
+}
+
+double msSsim(const Image& a, const Image& b, int threads)
+{
+    IMAGE_PROFILE(profile, "msSsim");
+    IMAGE_PROFILE_BYTES(profile, 6 * static_cast<std::uint64_t>(a.getWidth()) * a.getHeight(), 0);
+    static const double weights[] = {0.0448, 0.2856, 0.3001, 0.2363, 0.1333};
+    static const int scales = 5;
+
+    checkSizes(a, b);
+    if (a.getWidth() == 0 || a.getHeight() == 0)
+        return 1;
+
+    LumaPlane x = luma(a, threads);
+    LumaPlane y = luma(b, threads);
+
+    // Маленькие изображения нельзя уменьшить 4 раза так, чтобы окно 11x11 ещё помещалось,
+    // поэтому берём столько масштабов, сколько получается, и нормируем веса.
+    int usedScales = 1;
+    for (int size = std::min(x.width, x.height); usedScales < scales && size / 2 >= 2 * ssimRadius + 1; size /= 2)
+        usedScales++;
+
+    double weightSum = 0;
+    for (int s = 0; s < usedScales; ++s)
+        weightSum += weights[s];
+
+    double result = 1;
+    for (int s = 0; s < usedScales; ++s)
+    {
+        SsimResult stats = ssimStats(x, y, threads);
+        double weight = weights[s] / weightSum;
+        if (s == usedScales - 1)
+        {
+            result *= std::pow(std::max(stats.ssim, 0.0), weight);
+        }
+        else
+        {
+            result *= std::pow(std::max(stats.cs, 0.0), weight);
+            x = downsample(x);
+            y = downsample(y);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,183 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+#include "image_profiler.hpp"
+
+
+// mProfiler инициализируется первым, поэтому профилировщик (и его начало отсчёта) создаётся раньше,
+// чем засекается время первого замера
+ImageProfiler::Scope::Scope(const char* name) : mProfiler(instance()), mName(name), mStart(Clock::now())
+{
+}
+
+ImageProfiler::Scope::~Scope()
+{
+    mProfiler.record(mName, mStart, Clock::now(), mBytesRead, mBytesWritten);
+}
+
+void ImageProfiler::Scope::addBytes(std::uint64_t bytesRead, std::uint64_t bytesWritten)
+{
+    mBytesRead += bytesRead;
+    mBytesWritten += bytesWritten;
+}
+
+
+ImageProfiler::ImageProfiler() : mOrigin(Clock::now())
+{
+}
+
+ImageProfiler& ImageProfiler::instance()
+{
+    static ImageProfiler profiler;
+    return profiler;
+}
+
+int ImageProfiler::threadIndex()
+{
+    std::size_t id = std::hash<std::thread::id> {}(std::this_thread::get_id());
+    auto it = mThreads.find(id);
+    if (it == mThreads.end())
+        it = mThreads.emplace(id, static_cast<int>(mThreads.size())).first;
+    return it->second;
+}
+
+void ImageProfiler::record(const char* name, Clock::time_point start, Clock::time_point end,
+                           std::uint64_t bytesRead, std::uint64_t bytesWritten)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+
+    std::int64_t duration = duration_cast<nanoseconds>(end - start).count();
+
+    std::lock_guard<std::mutex> lock {mMutex};
+    OperationStats& stats = mStats[name];
+    stats.calls += 1;
+    stats.bytesRead += bytesRead;
+    stats.bytesWritten += bytesWritten;
+    stats.totalDuration += duration;
+    stats.minDuration = stats.calls == 1 ? duration : std::min(stats.minDuration, duration);
+    stats.maxDuration = std::max(stats.maxDuration, duration);
+    stats.histogram[histogramBucket(duration)] += 1;
+
+    if (mTrace.size() < maxTraceEvents)
+    {
+        std::int64_t offset = duration_cast<nanoseconds>(start - mOrigin).count();
+        mTrace.push_back({name, offset, duration, threadIndex(), bytesRead, bytesWritten});
+    }
+}
+
+// Корзины 0..7 - точные значения 0..7 нс, дальше по 8 корзин на каждую степень двойки
+int ImageProfiler::histogramBucket(std::int64_t duration)
+{
+    std::uint64_t d = static_cast<std::uint64_t>(std::max<std::int64_t>(duration, 0));
+    if (d < histogramSubBuckets)
+        return static_cast<int>(d);
+
+    int exponent = std::bit_width(d) - 1;
+    int sub = static_cast<int>((d >> (exponent - 3)) & (histogramSubBuckets - 1));
+    return histogramSubBuckets * (exponent - 2) + sub;
+}
+
+// Середина корзины
+double ImageProfiler::histogramValue(int bucket)
+{
+    if (bucket < histogramSubBuckets)
+        return bucket;
+
+    int exponent = bucket / histogramSubBuckets + 2;
+    int sub = bucket % histogramSubBuckets;
+    double width = std::ldexp(1.0, exponent - 3);
+    return (histogramSubBuckets + sub) * width + width / 2;
+}
+
+void ImageProfiler::printSummary(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock {mMutex};
+
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    auto milliseconds = [](double ns) { return ns / 1e6; };
+
+    out << std::left << std::setw(26) << "operation" << std::right
+        << std::setw(10) << "calls"
+        << std::setw(12) << "total ms"
+        << std::setw(12) << "mean ms"
+        << std::setw(12) << "p50 ms"
+        << std::setw(12) << "p95 ms"
+        << std::setw(12) << "p99 ms"
+        << std::setw(12) << "MB read"
+        << std::setw(12) << "MB written" << "\n";
+
+    for (const auto& [name, stats] : mStats)
+    {
+        auto percentile = [&stats](double p)
+        {
+            std::uint64_t rank = static_cast<std::uint64_t>(p * (stats.calls - 1) + 0.5);
+            std::uint64_t seen = 0;
+            for (int bucket = 0; bucket < histogramBuckets; ++bucket)
+            {
+                seen += stats.histogram[bucket];
+                if (seen > rank)
+                    return std::clamp(histogramValue(bucket), static_cast<double>(stats.minDuration),
+                                      static_cast<double>(stats.maxDuration));
+            }
+            return static_cast<double>(stats.maxDuration);
+        };
+
+        double total = static_cast<double>(stats.totalDuration);
+
+        out << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << stats.calls
+            << std::setw(12) << milliseconds(total)
+            << std::setw(12) << milliseconds(total / stats.calls)
+            << std::setw(12) << milliseconds(percentile(0.50))
+            << std::setw(12) << milliseconds(percentile(0.95))
+            << std::setw(12) << milliseconds(percentile(0.99))
+            << std::setw(12) << stats.bytesRead / 1e6
+            << std::setw(12) << stats.bytesWritten / 1e6 << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void ImageProfiler::writeChromeTrace(const std::string& filename) const
+{
+    std::ofstream out {filename};
+    if (out.fail())
+    {
+        std::cout << "Error. Can't open file!" << std::endl;
+        std::exit(1);
+    }
+
+    std::lock_guard<std::mutex> lock {mMutex};
+
+    // Время в формате Chrome Trace - в микросекундах
+    out << "{\"traceEvents\":[\n";
+    for (std::size_t k = 0; k < mTrace.size(); ++k)
+    {
+        const TraceEvent& e = mTrace[k];
+        out << "{\"name\":\"" << e.name << "\",\"cat\":\"image\",\"ph\":\"X\""
+            << std::fixed << std::setprecision(3)
+            << ",\"ts\":" << e.start / 1e3
+            << ",\"dur\":" << e.duration / 1e3
+            << ",\"pid\":1,\"tid\":" << e.thread
+            << ",\"args\":{\"bytesRead\":" << e.bytesRead << ",\"bytesWritten\":" << e.bytesWritten << "}}"
+            << (k + 1 < mTrace.size() ? ",\n" : "\n");
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void ImageProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock {mMutex};
+    mStats.clear();
+    mTrace.clear();
+    mOrigin = Clock::now();
+}
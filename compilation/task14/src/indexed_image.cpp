@@ -0,0 +1,415 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#include "indexed_image.hpp"
+
+
+static const int cacheBits = 5;
+static const int cacheSize = 1 << (3 * cacheBits);
+
+static int cacheKey(int r, int g, int b)
+{
+    return ((r >> 3) << (2 * cacheBits)) | ((g >> 3) << cacheBits) | (b >> 3);
+}
+
+
+IndexedImage::IndexedImage()
+{
+}
+
+IndexedImage::IndexedImage(int width, int height, Color background) : mWidth(width), mHeight(height)
+{
+    mPalette.push_back(background);
+    mIndices.assign(static_cast<std::size_t>(mWidth) * mHeight, 0);
+}
+
+IndexedImage::IndexedImage(const Image& image, int maxColors, bool dither)
+{
+    fromImage(image, maxColors, dither);
+}
+
+int IndexedImage::getWidth() const
+{
+    return mWidth;
+}
+
+int IndexedImage::getHeight() const
+{
+    return mHeight;
+}
+
+const std::vector<IndexedImage::Color>& IndexedImage::getPalette() const
+{
+    return mPalette;
+}
+
+unsigned char* IndexedImage::getIndices()
+{
+    return mIndices.data();
+}
+
+const unsigned char* IndexedImage::getIndices() const
+{
+    return mIndices.data();
+}
+
+void IndexedImage::setIndex(int i, int j, int index)
+{
+    assert(i >= 0 && i < mWidth && j >= 0 && j < mHeight);
+    assert(index >= 0 && index < static_cast<int>(mPalette.size()));
+
+    mIndices[static_cast<std::size_t>(j) * mWidth + i] = static_cast<unsigned char>(index);
+}
+
+int IndexedImage::getIndex(int i, int j) const
+{
+    assert(i >= 0 && i < mWidth && j >= 0 && j < mHeight);
+
+    return mIndices[static_cast<std::size_t>(j) * mWidth + i];
+}
+
+IndexedImage::Color IndexedImage::getPixel(int i, int j) const
+{
+    return mPalette[getIndex(i, j)];
+}
+
+int IndexedImage::findOrAddColor(Color c)
+{
+    for (std::size_t k = 0; k < mPalette.size(); ++k)
+    {
+        if (mPalette[k].r == c.r && mPalette[k].g == c.g && mPalette[k].b == c.b)
+            return static_cast<int>(k);
+    }
+
+    if (mPalette.size() < 256)
+    {
+        mPalette.push_back(c);
+        mNearestCache.clear();
+        return static_cast<int>(mPalette.size() - 1);
+    }
+
+    return nearest(c.r, c.g, c.b);
+}
+
+int IndexedImage::nearestSlow(int r, int g, int b) const
+{
+    int best = 0;
+    int bestDistance = std::numeric_limits<int>::max();
+    for (std::size_t k = 0; k < mPalette.size(); ++k)
+    {
+        int dr = r - mPalette[k].r;
+        int dg = g - mPalette[k].g;
+        int db = b - mPalette[k].b;
+        int distance = dr * dr + dg * dg + db * db;
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = static_cast<int>(k);
+        }
+    }
+    return best;
+}
+
+int IndexedImage::nearest(int r, int g, int b)
+{
+    if (mNearestCache.empty())
+        mNearestCache.assign(cacheSize, -1);
+
+    int key = cacheKey(r, g, b);
+    if (mNearestCache[key] < 0)
+    {
+        // Ищем ближайший цвет для центра ячейки, чтобы результат не зависел от того,
+        // какой пиксель первым попал в эту ячейку.
+        mNearestCache[key] = static_cast<std::int16_t>(nearestSlow((r & ~7) | 4, (g & ~7) | 4, (b & ~7) | 4));
+    }
+    return mNearestCache[key];
+}
+
+bool IndexedImage::buildExactPalette(const Image& image, int maxColors)
+{
+    std::unordered_map<std::uint32_t, unsigned char> indexOf;
+    std::vector<Color> palette;
+    std::vector<unsigned char> indices(static_cast<std::size_t>(image.getWidth()) * image.getHeight());
+
+    const unsigned char* data = image.getData();
+    std::uint32_t lastColor = std::numeric_limits<std::uint32_t>::max();
+    unsigned char lastIndex = 0;
+
+    for (std::size_t n = 0; n < indices.size(); ++n)
+    {
+        std::uint32_t color = (data[3 * n] << 16) | (data[3 * n + 1] << 8) | data[3 * n + 2];
+
+        // Соседние пиксели синтетических картинок почти всегда одного цвета
+        if (color != lastColor)
+        {
+            auto it = indexOf.find(color);
+            if (it == indexOf.end())
+            {
+                if (static_cast<int>(palette.size()) == maxColors)
+                    return false;
+
+                it = indexOf.emplace(color, static_cast<unsigned char>(palette.size())).first;
+                palette.push_back({data[3 * n], data[3 * n + 1], data[3 * n + 2]});
+            }
+            lastColor = color;
+            lastIndex = it->second;
+        }
+        indices[n] = lastIndex;
+    }
+
+    mPalette = std::move(palette);
+    mIndices = std::move(indices);
+    return true;
+}
+
+std::vector<IndexedImage::Color> IndexedImage::medianCut(const Image& image, int maxColors)
+{
+    struct Box
+    {
+        int lo[3];
+        int hi[3];
+    };
+
+    std::vector<std::uint32_t> counts(cacheSize, 0);
+    std::vector<std::uint64_t> sums(3 * cacheSize, 0);
+
+    const unsigned char* data = image.getData();
+    std::size_t pixelCount = static_cast<std::size_t>(image.getWidth()) * image.getHeight();
+    for (std::size_t n = 0; n < pixelCount; ++n)
+    {
+        int key = cacheKey(data[3 * n], data[3 * n + 1], data[3 * n + 2]);
+        counts[key] += 1;
+        sums[3 * key + 0] += data[3 * n + 0];
+        sums[3 * key + 1] += data[3 * n + 1];
+        sums[3 * key + 2] += data[3 * n + 2];
+    }
+
+    auto forEachBin = [&counts](const Box& box, auto&& f)
+    {
+        for (int r = box.lo[0]; r <= box.hi[0]; ++r)
+            for (int g = box.lo[1]; g <= box.hi[1]; ++g)
+                for (int b = box.lo[2]; b <= box.hi[2]; ++b)
+                {
+                    int key = (r << (2 * cacheBits)) | (g << cacheBits) | b;
+                    if (counts[key] != 0)
+                        f(key, r, g, b);
+                }
+    };
+
+    // Сжимает коробку до непустых ячеек и возвращает число пикселей в ней
+    auto shrink = [&](Box& box)
+    {
+        Box result {{31, 31, 31}, {0, 0, 0}};
+        std::uint64_t total = 0;
+        forEachBin(box, [&](int key, int r, int g, int b)
+        {
+            int v[3] = {r, g, b};
+            for (int c = 0; c < 3; ++c)
+            {
+                result.lo[c] = std::min(result.lo[c], v[c]);
+                result.hi[c] = std::max(result.hi[c], v[c]);
+            }
+            total += counts[key];
+        });
+        if (total != 0)
+            box = result;
+        return total;
+    };
+
+    std::vector<Box> boxes {{{0, 0, 0}, {31, 31, 31}}};
+    std::vector<std::uint64_t> boxCounts {shrink(boxes[0])};
+    if (boxCounts[0] == 0)
+        return {};
+
+    while (static_cast<int>(boxes.size()) < maxColors)
+    {
+        // Делим коробку с наибольшим произведением числа пикселей на длину самой длинной стороны
+        int chosen = -1;
+        int axis = 0;
+        std::uint64_t bestScore = 0;
+        for (std::size_t k = 0; k < boxes.size(); ++k)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                std::uint64_t score = boxCounts[k] * static_cast<std::uint64_t>(boxes[k].hi[c] - boxes[k].lo[c]);
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    chosen = static_cast<int>(k);
+                    axis = c;
+                }
+            }
+        }
+        if (chosen < 0)
+            break;
+
+        Box box = boxes[chosen];
+        std::vector<std::uint64_t> slices(32, 0);
+        forEachBin(box, [&](int key, int r, int g, int b)
+        {
+            int v[3] = {r, g, b};
+            slices[v[axis]] += counts[key];
+        });
+
+        int cut = box.lo[axis];
+        std::uint64_t accumulated = slices[cut];
+        while (cut + 1 < box.hi[axis] && 2 * accumulated < boxCounts[chosen])
+            accumulated += slices[++cut];
+
+        Box left = box;
+        Box right = box;
+        left.hi[axis] = cut;
+        right.lo[axis] = cut + 1;
+
+        boxes[chosen] = left;
+        boxCounts[chosen] = shrink(boxes[chosen]);
+        boxes.push_back(right);
+        boxCounts.push_back(shrink(boxes.back()));
+    }
+
+    std::vector<Color> palette;
+    for (const Box& box : boxes)
+    {
+        std::uint64_t total = 0;
+        std::uint64_t sum[3] = {0, 0, 0};
+        forEachBin(box, [&](int key, int, int, int)
+        {
+            total += counts[key];
+            for (int c = 0; c < 3; ++c)
+                sum[c] += sums[3 * key + c];
+        });
+        palette.push_back({static_cast<unsigned char>((sum[0] + total / 2) / total),
+                           static_cast<unsigned char>((sum[1] + total / 2) / total),
+                           static_cast<unsigned char>((sum[2] + total / 2) / total)});
+    }
+    return palette;
+}
+
+void IndexedImage::mapNearest(const Image& image)
+{
+    const unsigned char* data = image.getData();
+    for (std::size_t n = 0; n < mIndices.size(); ++n)
+        mIndices[n] = static_cast<unsigned char>(nearest(data[3 * n], data[3 * n + 1], data[3 * n + 2]));
+}
+
+void IndexedImage::mapDithered(const Image& image)
+{
+    // Ошибки текущей и следующей строки, по одному лишнему пикселю с каждой стороны
+    std::vector<int> current(3 * (mWidth + 2), 0);
+    std::vector<int> next(3 * (mWidth + 2), 0);
+    const unsigned char* data = image.getData();
+
+    for (int j = 0; j < mHeight; ++j)
+    {
+        std::fill(next.begin(), next.end(), 0);
+        for (int i = 0; i < mWidth; ++i)
+        {
+            std::size_t n = static_cast<std::size_t>(j) * mWidth + i;
+            int* error = &current[3 * (i + 1)];
+
+            int value[3];
+            for (int c = 0; c < 3; ++c)
+                value[c] = std::clamp(data[3 * n + c] + error[c] / 16, 0, 255);
+
+            int index = nearest(value[0], value[1], value[2]);
+            mIndices[n] = static_cast<unsigned char>(index);
+
+            const unsigned char chosen[3] = {mPalette[index].r, mPalette[index].g, mPalette[index].b};
+            for (int c = 0; c < 3; ++c)
+            {
+                int e = value[c] - chosen[c];
+                current[3 * (i + 2) + c] += 7 * e;
+                next[3 * i + c] += 3 * e;
+                next[3 * (i + 1) + c] += 5 * e;
+                next[3 * (i + 2) + c] += e;
+            }
+        }
+        std::swap(current, next);
+    }
+}
+
+void IndexedImage::fromImage(const Image& image, int maxColors, bool dither)
+{
+    maxColors = std::clamp(maxColors, 1, 256);
+    mWidth = image.getWidth();
+    mHeight = image.getHeight();
+    mNearestCache.clear();
+
+    if (buildExactPalette(image, maxColors))
+        return;
+
+    mPalette = medianCut(image, maxColors);
+    mIndices.resize(static_cast<std::size_t>(mWidth) * mHeight);
+    if (dither)
+        mapDithered(image);
+    else
+        mapNearest(image);
+}
+
+Image IndexedImage::toImage() const
+{
+    Image result(mWidth, mHeight);
+    Color* out = result.begin();
+    for (std::size_t n = 0; n < mIndices.size(); ++n)
+        out[n] = mPalette[mIndices[n]];
+    return result;
+}
+
+void IndexedImage::drawCircle(int radius, int centerX, int centerY, Color c)
+{
+    int index = findOrAddColor(c);
+    for (int j = std::max(centerY - radius, 0); j < std::min(centerY + radius, mHeight); j++)
+    {
+        for (int i = std::max(centerX - radius, 0); i < std::min(centerX + radius, mWidth); i++)
+        {
+            if ((i - centerX) * (i - centerX) + (j - centerY) * (j - centerY) < radius * radius)
+                setIndex(i, j, index);
+        }
+    }
+}
+
+void IndexedImage::drawLine(int x1, int y1, int x2, int y2, Color c)
+{
+    int index = findOrAddColor(c);
+
+    bool steep = (std::abs(y2 - y1) > std::abs(x2 - x1));
+    if (steep)
+    {
+        std::swap(x1, y1);
+        std::swap(x2, y2);
+    }
+
+    if (x1 > x2)
+    {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+
+    int dx = x2 - x1;
+    int dy = std::abs(y2 - y1);
+
+    int error = dx / 2;
+    int ystep = (y1 < y2) ? 1 : -1;
+    int y = y1;
+
+    for (int x = x1; x <= x2; x++)
+    {
+        if (steep)
+            setIndex(y, x, index);
+        else
+            setIndex(x, y, index);
+
+        error -= dy;
+        if (error < 0)
+        {
+            y += ystep;
+            error += dx;
+        }
+    }
+}
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PLANAR_IMAGE_HAS_SSSE3
+#include <immintrin.h>
+#endif
+
+#include "planar_image.hpp"
+
+
+PlanarImage::PlanarImage()
+{
+}
+
+PlanarImage::PlanarImage(const std::string& filename)
+{
+    load(filename);
+}
+
+PlanarImage::PlanarImage(const Image& image)
+{
+    fromImage(image);
+}
+
+PlanarImage::PlanarImage(int width, int height)
+{
+    resize(width, height);
+}
+
+PlanarImage::PlanarImage(int width, int height, Color c)
+{
+    resize(width, height);
+    fill(c);
+}
+
+int PlanarImage::getWidth() const
+{
+    return mWidth;
+}
+
+int PlanarImage::getHeight() const
+{
+    return mHeight;
+}
+
+unsigned char* PlanarImage::getPlane(int channel)
+{
+    assert(channel >= 0 && channel < 3);
+    return mPlanes[channel].data();
+}
+
+const unsigned char* PlanarImage::getPlane(int channel) const
+{
+    assert(channel >= 0 && channel < 3);
+    return mPlanes[channel].data();
+}
+
+void PlanarImage::setPixel(int i, int j, Color c)
+{
+    assert(i >= 0 && i < mWidth && j >= 0 && j < mHeight);
+
+    std::size_t index = static_cast<std::size_t>(j) * mWidth + i;
+    mPlanes[0][index] = c.r;
+    mPlanes[1][index] = c.g;
+    mPlanes[2][index] = c.b;
+}
+
+PlanarImage::Color PlanarImage::getPixel(int i, int j) const
+{
+    assert(i >= 0 && i < mWidth && j >= 0 && j < mHeight);
+
+    std::size_t index = static_cast<std::size_t>(j) * mWidth + i;
+    return {mPlanes[0][index], mPlanes[1][index], mPlanes[2][index]};
+}
+
+void PlanarImage::resize(int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
+    for (Plane& plane : mPlanes)
+        plane.resize(static_cast<std::size_t>(mWidth) * mHeight);
+}
+
+void PlanarImage::fromImage(const Image& image)
+{
+    resize(image.getWidth(), image.getHeight());
+    deinterleave(image.getData(), mPlanes[0].data(), mPlanes[1].data(), mPlanes[2].data(), mPlanes[0].size());
+}
+
+Image PlanarImage::toImage() const
+{
+    Image result(mWidth, mHeight);
+    interleave(mPlanes[0].data(), mPlanes[1].data(), mPlanes[2].data(), result.getData(), mPlanes[0].size());
+    return result;
+}
+
+void PlanarImage::load(const std::string& filename)
+{
+    Image image(filename);
+    fromImage(image);
+}
+
+void PlanarImage::save(const std::string& filename) const
+{
+    toImage().save(filename);
+}
+
+void PlanarImage::fill(Color c)
+{
+    std::memset(mPlanes[0].data(), c.r, mPlanes[0].size());
+    std::memset(mPlanes[1].data(), c.g, mPlanes[1].size());
+    std::memset(mPlanes[2].data(), c.b, mPlanes[2].size());
+}
+
+void PlanarImage::fillSpan(int j, int iBegin, int iEnd, Color c)
+{
+    if (iBegin >= iEnd)
+        return;
+
+    std::size_t offset = static_cast<std::size_t>(j) * mWidth + iBegin;
+    std::size_t length = iEnd - iBegin;
+    std::memset(mPlanes[0].data() + offset, c.r, length);
+    std::memset(mPlanes[1].data() + offset, c.g, length);
+    std::memset(mPlanes[2].data() + offset, c.b, length);
+}
+
+void PlanarImage::drawCircle(int radius, int centerX, int centerY, Color c)
+{
+    // Для каждой строки находим отрезок [iBegin, iEnd) внутри круга и заливаем его в трёх плоскостях сразу.
+    // Условие то же, что в Image::drawCircle: (i - centerX)^2 + (j - centerY)^2 < radius^2.
+    for (int j = std::max(centerY - radius, 0); j < std::min(centerY + radius, mHeight); j++)
+    {
+        int dy = j - centerY;
+        int rest = radius * radius - dy * dy;
+        if (rest <= 0)
+            continue;
+
+        int dx = static_cast<int>(std::sqrt(static_cast<double>(rest)));
+        while (dx * dx >= rest)
+            dx--;
+        while ((dx + 1) * (dx + 1) < rest)
+            dx++;
+
+        int iBegin = std::max({centerX - dx, centerX - radius, 0});
+        int iEnd = std::min({centerX + dx + 1, centerX + radius, mWidth});
+        fillSpan(j, iBegin, iEnd, c);
+    }
+}
+
+void PlanarImage::drawLine(int x1, int y1, int x2, int y2, Color c)
+{
+    bool steep = (std::abs(y2 - y1) > std::abs(x2 - x1));
+    if (steep)
+    {
+        std::swap(x1, y1);
+        std::swap(x2, y2);
+    }
+
+    if (x1 > x2)
+    {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+
+    int dx = x2 - x1;
+    int dy = std::abs(y2 - y1);
+
+    int error = dx / 2;
+    int ystep = (y1 < y2) ? 1 : -1;
+    int y = y1;
+
+    for (int x = x1; x <= x2; x++)
+    {
+        if (steep)
+            setPixel(y, x, c);
+        else
+            setPixel(x, y, c);
+
+        error -= dy;
+        if (error < 0)
+        {
+            y += ystep;
+            error += dx;
+        }
+    }
+}
+
+
+#ifdef PLANAR_IMAGE_HAS_SSSE3
+
+// Маски для _mm_shuffle_epi8. Блок из 16 пикселей - это 48 байт RGB, то есть три 16-байтовых регистра.
+// deinterleaveMask(ch, k)[i] - где в k-м регистре лежит компонента ch пикселя i (0x80 - байта там нет).
+// interleaveMask(ch, k)[j]   - из какого байта плоскости ch берётся j-й байт k-го выходного регистра.
+
+static __m128i deinterleaveMask(int ch, int k)
+{
+    alignas(16) char mask[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        int pos = 3 * i + ch - 16 * k;
+        mask[i] = (pos >= 0 && pos < 16) ? static_cast<char>(pos) : static_cast<char>(0x80);
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+static __m128i interleaveMask(int ch, int k)
+{
+    alignas(16) char mask[16];
+    for (int j = 0; j < 16; ++j)
+    {
+        int pos = 16 * k + j;
+        mask[j] = (pos % 3 == ch) ? static_cast<char>(pos / 3) : static_cast<char>(0x80);
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+__attribute__((target("ssse3")))
+static std::size_t deinterleaveSsse3(const unsigned char* rgb, unsigned char* r, unsigned char* g, unsigned char* b,
+                                     std::size_t count)
+{
+    __m128i masks[3][3];
+    for (int ch = 0; ch < 3; ++ch)
+        for (int k = 0; k < 3; ++k)
+            masks[ch][k] = deinterleaveMask(ch, k);
+
+    unsigned char* planes[3] = {r, g, b};
+    std::size_t n = 0;
+    for (; n + 16 <= count; n += 16)
+    {
+        __m128i in[3];
+        for (int k = 0; k < 3; ++k)
+            in[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * n + 16 * k));
+
+        for (int ch = 0; ch < 3; ++ch)
+        {
+            __m128i out = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(in[0], masks[ch][0]),
+                                                    _mm_shuffle_epi8(in[1], masks[ch][1])),
+                                       _mm_shuffle_epi8(in[2], masks[ch][2]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[ch] + n), out);
+        }
+    }
+    return n;
+}
+
+__attribute__((target("ssse3")))
+static std::size_t interleaveSsse3(const unsigned char* r, const unsigned char* g, const unsigned char* b,
+                                   unsigned char* rgb, std::size_t count)
+{
+    __m128i masks[3][3];
+    for (int ch = 0; ch < 3; ++ch)
+        for (int k = 0; k < 3; ++k)
+            masks[ch][k] = interleaveMask(ch, k);
+
+    std::size_t n = 0;
+    for (; n + 16 <= count; n += 16)
+    {
+        __m128i in[3];
+        in[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + n));
+        in[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + n));
+        in[2] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n));
+
+        for (int k = 0; k < 3; ++k)
+        {
+            __m128i out = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(in[0], masks[0][k]),
+                                                    _mm_shuffle_epi8(in[1], masks[1][k])),
+                                       _mm_shuffle_epi8(in[2], masks[2][k]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + 3 * n + 16 * k), out);
+        }
+    }
+    return n;
+}
+
+static bool hasSsse3()
+{
+    static const bool result = __builtin_cpu_supports("ssse3");
+    return result;
+}
+
+#endif
+
+
+void PlanarImage::deinterleave(const unsigned char* rgb, unsigned char* r, unsigned char* g, unsigned char* b,
+                               std::size_t count)
+{
+    std::size_t n = 0;
+#ifdef PLANAR_IMAGE_HAS_SSSE3
+    if (hasSsse3())
+        n = deinterleaveSsse3(rgb, r, g, b, count);
+#endif
+    for (; n < count; ++n)
+    {
+        r[n] = rgb[3 * n + 0];
+        g[n] = rgb[3 * n + 1];
+        b[n] = rgb[3 * n + 2];
+    }
+}
+
+void PlanarImage::interleave(const unsigned char* r, const unsigned char* g, const unsigned char* b,
+                             unsigned char* rgb, std::size_t count)
+{
+    std::size_t n = 0;
+#ifdef PLANAR_IMAGE_HAS_SSSE3
+    if (hasSsse3())
+        n = interleaveSsse3(r, g, b, rgb, count);
+#endif
+    for (; n < count; ++n)
+    {
+        rgb[3 * n + 0] = r[n];
+        rgb[3 * n + 1] = g[n];
+        rgb[3 * n + 2] = b[n];
+    }
+}
@@ -0,0 +1,237 @@
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "sparse_image.hpp"
+
+
+static bool sameColor(Image::Color a, Image::Color b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+
+SparseImage::SparseImage()
+{
+}
+
+SparseImage::SparseImage(int width, int height) : mWidth(width), mHeight(height), mRows(height)
+{
+}
+
+SparseImage::SparseImage(const Image& image, Color background)
+    : mWidth(image.getWidth()), mHeight(image.getHeight()), mRows(image.getHeight())
+{
+    for (int j = 0; j < mHeight; ++j)
+    {
+        std::span<const Color> row = image.row(j);
+        int i = 0;
+        while (i < mWidth)
+        {
+            int start = i;
+            while (i < mWidth && sameColor(row[i], row[start]))
+                i++;
+
+            if (!sameColor(row[start], background))
+                mRows[j].push_back({start, i - start, row[start]});
+        }
+    }
+}
+
+int SparseImage::getWidth() const
+{
+    return mWidth;
+}
+
+int SparseImage::getHeight() const
+{
+    return mHeight;
+}
+
+const std::vector<SparseImage::Run>& SparseImage::getRow(int j) const
+{
+    assert(j >= 0 && j < mHeight);
+    return mRows[j];
+}
+
+std::size_t SparseImage::getRunCount() const
+{
+    std::size_t count = 0;
+    for (const std::vector<Run>& row : mRows)
+        count += row.size();
+    return count;
+}
+
+std::size_t SparseImage::getMemoryUsage() const
+{
+    std::size_t bytes = mRows.capacity() * sizeof(std::vector<Run>);
+    for (const std::vector<Run>& row : mRows)
+        bytes += row.capacity() * sizeof(Run);
+    return bytes;
+}
+
+void SparseImage::setPixel(int i, int j, Color c)
+{
+    assert(i >= 0 && i < mWidth && j >= 0 && j < mHeight);
+    fillSpan(j, i, i + 1, c);
+}
+
+bool SparseImage::getPixel(int i, int j, Color& c) const
+{
+    assert(i >= 0 && i < mWidth && j >= 0 && j < mHeight);
+
+    const std::vector<Run>& row = mRows[j];
+    auto it = std::upper_bound(row.begin(), row.end(), i, [](int x, const Run& run) { return x < run.start; });
+    if (it == row.begin())
+        return false;
+
+    --it;
+    if (i >= it->start + it->length)
+        return false;
+
+    c = it->color;
+    return true;
+}
+
+void SparseImage::fillSpan(int j, int iBegin, int iEnd, Color c)
+{
+    assert(j >= 0 && j < mHeight);
+    iBegin = std::max(iBegin, 0);
+    iEnd = std::min(iEnd, mWidth);
+    if (iBegin >= iEnd)
+        return;
+
+    std::vector<Run>& row = mRows[j];
+
+    // [first, last) - отрезки, которые пересекаются с [iBegin, iEnd) или касаются его.
+    // Отрезки того же цвета склеиваются с новым, у остальных остаются только части снаружи [iBegin, iEnd).
+    auto first = std::lower_bound(row.begin(), row.end(), iBegin,
+                                  [](const Run& run, int x) { return run.start + run.length < x; });
+    auto last = first;
+    while (last != row.end() && last->start <= iEnd)
+        ++last;
+
+    Run inserted {iBegin, iEnd - iBegin, c};
+    Run pieces[3];
+    int pieceCount = 0;
+    bool hasRight = false;
+    Run right {};
+
+    for (auto it = first; it != last; ++it)
+    {
+        int runEnd = it->start + it->length;
+        if (sameColor(it->color, c))
+        {
+            int newEnd = std::max(inserted.start + inserted.length, runEnd);
+            inserted.start = std::min(inserted.start, it->start);
+            inserted.length = newEnd - inserted.start;
+            continue;
+        }
+
+        if (it->start < iBegin)
+            pieces[pieceCount++] = {it->start, std::min(runEnd, iBegin) - it->start, it->color};
+        if (runEnd > iEnd)
+        {
+            int start = std::max(it->start, iEnd);
+            right = {start, runEnd - start, it->color};
+            hasRight = true;
+        }
+    }
+
+    pieces[pieceCount++] = inserted;
+    if (hasRight)
+        pieces[pieceCount++] = right;
+
+    auto position = row.erase(first, last);
+    row.insert(position, pieces, pieces + pieceCount);
+}
+
+void SparseImage::clear()
+{
+    for (std::vector<Run>& row : mRows)
+        row.clear();
+}
+
+void SparseImage::drawCircle(int radius, int centerX, int centerY, Color c)
+{
+    for (int j = std::max(centerY - radius, 0); j < std::min(centerY + radius, mHeight); j++)
+    {
+        int dy = j - centerY;
+        int rest = radius * radius - dy * dy;
+        if (rest <= 0)
+            continue;
+
+        int dx = static_cast<int>(std::sqrt(static_cast<double>(rest)));
+        while (dx * dx >= rest)
+            dx--;
+        while ((dx + 1) * (dx + 1) < rest)
+            dx++;
+
+        fillSpan(j, std::max(centerX - dx, centerX - radius), std::min(centerX + dx + 1, centerX + radius), c);
+    }
+}
+
+void SparseImage::drawLine(int x1, int y1, int x2, int y2, Color c)
+{
+    bool steep = (std::abs(y2 - y1) > std::abs(x2 - x1));
+    if (steep)
+    {
+        std::swap(x1, y1);
+        std::swap(x2, y2);
+    }
+
+    if (x1 > x2)
+    {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+
+    int dx = x2 - x1;
+    int dy = std::abs(y2 - y1);
+
+    int error = dx / 2;
+    int ystep = (y1 < y2) ? 1 : -1;
+    int y = y1;
+
+    // У пологой линии соседние пиксели лежат в одной строке, поэтому пишем их одним отрезком
+    int spanStart = x1;
+    for (int x = x1; x <= x2; x++)
+    {
+        if (steep)
+            setPixel(y, x, c);
+
+        error -= dy;
+        if (error < 0)
+        {
+            if (!steep)
+            {
+                fillSpan(y, spanStart, x + 1, c);
+                spanStart = x + 1;
+            }
+            y += ystep;
+            error += dx;
+        }
+    }
+
+    if (!steep && spanStart <= x2)
+        fillSpan(y, spanStart, x2 + 1, c);
+}
+
+void SparseImage::blitTo(Image& dst, int x, int y) const
+{
+    int jBegin = std::max(0, -y);
+    int jEnd = std::min(mHeight, dst.getHeight() - y);
+
+    for (int j = jBegin; j < jEnd; ++j)
+    {
+        std::span<Color> dstRow = dst.row(j + y);
+        for (const Run& run : mRows[j])
+        {
+            int begin = std::max(run.start + x, 0);
+            int end = std::min(run.start + run.length + x, dst.getWidth());
+            if (begin < end)
+                std::fill(dstRow.begin() + begin, dstRow.begin() + end, run.color);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef PACKED_TIME_HPP
+#define PACKED_TIME_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "time.hpp"
+
+// Compact time: one int32 number of seconds (about +-68 years, that is +-596523 hours), 4 bytes instead of 8
+// for Time. Constructors and arithmetic compute in 64 bits and throw std::out_of_range if the result
+// does not fit; in a constant expression that is a compile error. Time allows longer durations,
+// so PackedTime(const Time&) is checked the same way.
+// Arithmetic and comparison are single integer operations and work at compile time (constexpr).
+// Days, hours, minutes and seconds are split out only when asked for.
+//
+// The interface follows Time: PackedTime(hours, minutes), getHours() (total hours, may exceed 23),
+// getMinutes(), reset(), += and +. Conversion to and from Time: PackedTime(const Time&) and toTime().
+// The getters expect a non-negative time.
+
+class PackedTime {
+private:
+    std::int32_t seconds;
+
+    struct Raw {};
+    constexpr PackedTime(Raw, std::int32_t totalSeconds) : seconds(totalSeconds) {}
+
+    static constexpr std::int32_t checked(std::int64_t totalSeconds) {
+        if (totalSeconds < INT32_MIN || totalSeconds > INT32_MAX)
+            throw std::out_of_range("PackedTime: the time does not fit in int32 seconds");
+        return static_cast<std::int32_t>(totalSeconds);
+    }
+
+public:
+    constexpr PackedTime() : seconds(0) {}
+    constexpr PackedTime(int hours, int minutes) : seconds(checked(3600 * std::int64_t(hours) + 60 * std::int64_t(minutes))) {}
+    constexpr PackedTime(int days, int hours, int minutes, int seconds)
+        : seconds(checked(86400 * std::int64_t(days) + 3600 * std::int64_t(hours) + 60 * std::int64_t(minutes) + seconds)) {}
+    explicit PackedTime(const Time& t) : PackedTime(t.getHours(), t.getMinutes()) {}
+
+    static constexpr PackedTime fromSeconds(std::int32_t totalSeconds) { return PackedTime(Raw{}, totalSeconds); }
+    static constexpr PackedTime fromMinutes(std::int32_t totalMinutes) { return PackedTime(Raw{}, checked(60 * std::int64_t(totalMinutes))); }
+
+    constexpr std::int32_t totalSeconds() const { return seconds; }
+    constexpr std::int32_t totalMinutes() const { return seconds / 60; }
+
+    constexpr int getDays() const { return seconds / 86400; }
+    constexpr int getHours() const { return seconds / 3600; }
+    constexpr int getHourOfDay() const { return seconds / 3600 % 24; }
+    constexpr int getMinutes() const { return seconds / 60 % 60; }
+    constexpr int getSeconds() const { return seconds % 60; }
+
+    Time toTime() const { return Time(getHours(), getMinutes()); }
+
+    constexpr void reset() { seconds = 0; }
+
+    constexpr PackedTime& operator+=(const PackedTime& right) {
+        seconds = checked(std::int64_t(seconds) + right.seconds);
+        return *this;
+    }
+    constexpr PackedTime& operator-=(const PackedTime& right) {
+        seconds = checked(std::int64_t(seconds) - right.seconds);
+        return *this;
+    }
+    constexpr PackedTime operator+(const PackedTime& right) const {
+        return PackedTime(Raw{}, checked(std::int64_t(seconds) + right.seconds));
+    }
+    constexpr PackedTime operator-(const PackedTime& right) const {
+        return PackedTime(Raw{}, checked(std::int64_t(seconds) - right.seconds));
+    }
+
+    constexpr bool operator==(const PackedTime& right) const { return seconds == right.seconds; }
+    constexpr bool operator!=(const PackedTime& right) const { return seconds != right.seconds; }
+    constexpr bool operator<(const PackedTime& right) const { return seconds < right.seconds; }
+    constexpr bool operator<=(const PackedTime& right) const { return seconds <= right.seconds; }
+    constexpr bool operator>(const PackedTime& right) const { return seconds > right.seconds; }
+    constexpr bool operator>=(const PackedTime& right) const { return seconds >= right.seconds; }
+};
+
+static_assert(sizeof(PackedTime) == 4, "PackedTime must stay one 32-bit integer");
+static_assert(PackedTime(5, 9) + PackedTime(10, 55) == PackedTime(16, 4), "constexpr arithmetic");
+static_assert(PackedTime(1, 2, 3, 4).getHours() == 26 && PackedTime(1, 2, 3, 4).getSeconds() == 4, "constexpr getters");
+
+// Always HH:MM:SS (total hours, so HH may be longer than two digits); unlike Time, seconds are kept
+inline std::ostream& operator<<(std::ostream& out, PackedTime t) {
+    out << std::setw(2) << std::setfill('0') << t.getHours() << ":"
+        << std::setw(2) << std::setfill('0') << t.getMinutes() << ":"
+        << std::setw(2) << std::setfill('0') << t.getSeconds();
+    return out;
+}
+
+#endif // PACKED_TIME_HPP
@@ -11,6 +11,8 @@ private:
 
 public:
     Time(int hours, int minutes);
+    int getHours() const { return hours; }
+    int getMinutes() const { return minutes; }
     void reset();
     Time& operator+=(const Time& right);
     Time operator+(const Time& right) const;
@@ -0,0 +1,134 @@
+#include "time_aggregation.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+int resolveThreads(int threads, std::size_t count) {
+    if (threads <= 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    // Not worth starting a thread for less than this many elements
+    const std::size_t minimalShare = 1 << 16;
+    std::size_t useful = std::max<std::size_t>(1, count / minimalShare);
+    return static_cast<int>(std::min<std::size_t>(threads, useful));
+}
+
+// Runs f(begin, end, threadIndex) on threads parts of [0, count)
+template<typename F>
+void runParts(std::size_t count, int threads, F f) {
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t)
+        workers.emplace_back(f, count * t / threads, count * (t + 1) / threads, t);
+    f(0, count / threads, 0);
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void add(BucketStats& bucket, double value) {
+    if (bucket.count == 0) {
+        bucket.min = value;
+        bucket.max = value;
+    }
+    else {
+        bucket.min = std::min(bucket.min, value);
+        bucket.max = std::max(bucket.max, value);
+    }
+    bucket.count += 1;
+    bucket.sum += value;
+}
+
+void merge(BucketStats& bucket, const BucketStats& part) {
+    if (part.count == 0)
+        return;
+    if (bucket.count == 0) {
+        bucket = part;
+        return;
+    }
+    bucket.count += part.count;
+    bucket.sum += part.sum;
+    bucket.min = std::min(bucket.min, part.min);
+    bucket.max = std::max(bucket.max, part.max);
+}
+
+std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+    std::int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+}
+
+Time Buckets::bucketStart(std::size_t index) const {
+    std::int64_t minute = first + static_cast<std::int64_t>(index) * width;
+    return Time(static_cast<int>(minute / 60), static_cast<int>(minute % 60));
+}
+
+std::int32_t packMinutes(const Time& t) {
+    std::int64_t minutes = std::int64_t(t.getHours()) * 60 + t.getMinutes();
+    if (minutes < INT32_MIN || minutes > INT32_MAX)
+        throw std::out_of_range("packMinutes: the time does not fit in int32 minutes");
+    return static_cast<std::int32_t>(minutes);
+}
+
+std::vector<std::int32_t> packMinutes(const std::vector<Time>& times) {
+    std::vector<std::int32_t> result(times.size());
+    for (std::size_t i = 0; i < times.size(); ++i)
+        result[i] = packMinutes(times[i]);
+    return result;
+}
+
+Buckets aggregate(const std::int32_t* minutes, const double* values, std::size_t count, int width, int threads) {
+    assert(width > 0);
+    Buckets result;
+    result.width = width;
+    if (count == 0)
+        return result;
+
+    threads = resolveThreads(threads, count);
+
+    // First pass: the range of minutes, to size the bucket arrays
+    std::vector<std::int32_t> lows(threads), highs(threads);
+    runParts(count, threads, [&](std::size_t begin, std::size_t end, int t) {
+        auto range = std::minmax_element(minutes + begin, minutes + end);
+        lows[t] = *range.first;
+        highs[t] = *range.second;
+    });
+    std::int32_t low = *std::min_element(lows.begin(), lows.end());
+    std::int32_t high = *std::max_element(highs.begin(), highs.end());
+
+    // In 64 bits: the span of two int32 values does not always fit in int32
+    result.first = floorDiv(low, width) * width;
+    std::int64_t lastBucket = (high - result.first) / width;
+    if (lastBucket >= static_cast<std::int64_t>(maxBuckets))
+        throw std::length_error("aggregate: the times span more than maxBuckets buckets");
+    std::size_t bucketCount = static_cast<std::size_t>(lastBucket) + 1;
+
+    // Second pass: per-thread partial buckets, thread 0 writes straight into the result
+    result.stats.resize(bucketCount);
+    std::vector<std::vector<BucketStats>> partials(threads - 1, std::vector<BucketStats>(bucketCount));
+    runParts(count, threads, [&](std::size_t begin, std::size_t end, int t) {
+        BucketStats* buckets = t == 0 ? result.stats.data() : partials[t - 1].data();
+        const std::int64_t first = result.first;
+        if (width == 1) {
+            for (std::size_t i = begin; i < end; ++i)
+                add(buckets[minutes[i] - first], values[i]);
+        }
+        else {
+            for (std::size_t i = begin; i < end; ++i)
+                add(buckets[(minutes[i] - first) / width], values[i]);
+        }
+    });
+
+    for (const std::vector<BucketStats>& partial : partials)
+        for (std::size_t b = 0; b < bucketCount; ++b)
+            merge(result.stats[b], partial[b]);
+    return result;
+}
+
+Buckets aggregate(const std::vector<Time>& times, const std::vector<double>& values, int width, int threads) {
+    assert(times.size() == values.size());
+    std::vector<std::int32_t> minutes = packMinutes(times);
+    return aggregate(minutes.data(), values.data(), minutes.size(), width, threads);
+}
@@ -0,0 +1,54 @@
+#ifndef TIME_AGGREGATION_HPP
+#define TIME_AGGREGATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "time.hpp"
+
+// Aggregation of metric values over time buckets.
+//
+// Times are kept as packed minute counts (hours * 60 + minutes in one int32), so bucketing is a
+// subtraction and a division instead of Time arithmetic. Time objects are converted only at the edges:
+// packMinutes on input and Buckets::bucketStart on output. Time allows longer durations than that:
+// packMinutes throws std::out_of_range if hours * 60 + minutes does not fit in int32
+// (hours up to 35791394).
+//
+// aggregate splits the input between threads (threads = 0 - one per hardware thread). Every thread
+// fills its own partial buckets, and the partials are merged at the end, so there is no locking
+// in the hot loop. Bucket i covers minutes [first + i * width, first + (i + 1) * width);
+// first is the earliest minute rounded down to a multiple of width.
+//
+// The buckets are a dense array from the earliest to the latest time, and every thread has its own copy,
+// so a single outlier could make them huge. aggregate throws std::length_error if the times span
+// more than maxBuckets buckets; choose a wider bucket for such data.
+
+const int minuteBuckets = 1;
+const int hourBuckets = 60;
+const int dayBuckets = 24 * 60;
+
+const std::size_t maxBuckets = std::size_t(1) << 22;
+
+struct BucketStats {
+    std::int64_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+};
+
+struct Buckets {
+    int width = 1;
+    std::int64_t first = 0;
+    std::vector<BucketStats> stats;
+
+    Time bucketStart(std::size_t index) const;
+};
+
+std::int32_t packMinutes(const Time& t);
+std::vector<std::int32_t> packMinutes(const std::vector<Time>& times);
+
+Buckets aggregate(const std::int32_t* minutes, const double* values, std::size_t count, int width, int threads = 0);
+Buckets aggregate(const std::vector<Time>& times, const std::vector<double>& values, int width, int threads = 0);
+
+#endif // TIME_AGGREGATION_HPP
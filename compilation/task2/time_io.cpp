@@ -0,0 +1,200 @@
+#include "time_io.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const std::size_t recordSize = 6;
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Parses one record at text[position]; on success appends it and moves position past it
+bool parseRecord(std::string_view text, std::size_t& position, std::vector<Time>& out, char separator) {
+    const char* p = text.data() + position;
+    const char* end = text.data() + text.size();
+
+    // Hours: two digits, or more without a leading zero
+    const char* q = p;
+    int hours = 0;
+    while (q < end && isDigit(*q)) {
+        int digit = *q - '0';
+        if (hours > (INT_MAX - digit) / 10)
+            return false;
+        hours = 10 * hours + digit;
+        ++q;
+    }
+    if (q - p < 2 || (q - p > 2 && p[0] == '0'))
+        return false;
+
+    if (end - q < 3 || q[0] != ':' || !isDigit(q[1]) || !isDigit(q[2]))
+        return false;
+    int minutes = 10 * (q[1] - '0') + (q[2] - '0');
+    if (minutes > 59)
+        return false;
+    q += 3;
+
+    if (q < end) {
+        if (*q != separator)
+            return false;
+        ++q;
+    }
+
+    out.emplace_back(hours, minutes);
+    position = static_cast<std::size_t>(q - text.data());
+    return true;
+}
+
+#ifdef __SSE2__
+
+// 48 bytes = 8 records = 3 registers. Byte i of a record: 0, 1, 3, 4 - digits, 2 - ':', 5 - separator.
+struct ChunkPatterns {
+    __m128i isDigit[3];
+    __m128i expected[3];
+    __m128i minutesLimit[3];
+};
+
+ChunkPatterns makePatterns(char separator) {
+    alignas(16) std::uint8_t isDigitBytes[48];
+    alignas(16) std::uint8_t expectedBytes[48];
+    alignas(16) std::int16_t minutesLimits[24];
+
+    for (int i = 0; i < 48; ++i) {
+        int column = i % recordSize;
+        isDigitBytes[i] = column == 2 || column == 5 ? 0 : 0xff;
+        expectedBytes[i] = column == 2 ? ':' : column == 5 ? separator : 0;
+    }
+    // In 16-bit lanes the hours of record k are lane 3k; after a shift by one byte the minutes are lane 3k + 1.
+    // Any two-digit hours are valid, so only the minutes are checked.
+    for (int i = 0; i < 24; ++i)
+        minutesLimits[i] = i % 3 == 1 ? 60 : INT16_MAX;
+
+    ChunkPatterns patterns;
+    for (int j = 0; j < 3; ++j) {
+        patterns.isDigit[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(isDigitBytes + 16 * j));
+        patterns.expected[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(expectedBytes + 16 * j));
+        patterns.minutesLimit[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(minutesLimits + 8 * j));
+    }
+    return patterns;
+}
+
+// Byte pairs (a, b) in 16-bit lanes -> 10 * a + b
+__m128i pairsToNumbers(__m128i digits) {
+    __m128i first = _mm_and_si128(digits, _mm_set1_epi16(0x00ff));
+    __m128i second = _mm_srli_epi16(digits, 8);
+    return _mm_add_epi16(_mm_mullo_epi16(first, _mm_set1_epi16(10)), second);
+}
+
+// Parses 8 records at p; returns false (and appends nothing) if any of them is malformed
+bool parseChunk(const char* p, const ChunkPatterns& patterns, std::vector<Time>& out) {
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+
+    __m128i digits[3];
+    __m128i valid = _mm_set1_epi8(-1);
+    for (int j = 0; j < 3; ++j) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * j));
+        digits[j] = _mm_sub_epi8(v, zero);
+        __m128i digitOk = _mm_cmpeq_epi8(_mm_max_epu8(digits[j], nine), nine);
+        __m128i byteOk = _mm_cmpeq_epi8(v, patterns.expected[j]);
+        __m128i ok = _mm_or_si128(_mm_and_si128(patterns.isDigit[j], digitOk),
+                                  _mm_andnot_si128(patterns.isDigit[j], byteOk));
+        valid = _mm_and_si128(valid, ok);
+    }
+    if (_mm_movemask_epi8(valid) != 0xffff)
+        return false;
+
+    alignas(16) std::int16_t hours[24];
+    alignas(16) std::int16_t minutes[24];
+    __m128i inRange = _mm_set1_epi16(-1);
+    for (int j = 0; j < 3; ++j) {
+        __m128i next = j < 2 ? digits[j + 1] : _mm_setzero_si128();
+        __m128i shifted = _mm_or_si128(_mm_srli_si128(digits[j], 1), _mm_slli_si128(next, 15));
+
+        __m128i h = pairsToNumbers(digits[j]);
+        __m128i m = pairsToNumbers(shifted);
+        inRange = _mm_and_si128(inRange, _mm_cmplt_epi16(m, patterns.minutesLimit[j]));
+        _mm_store_si128(reinterpret_cast<__m128i*>(hours + 8 * j), h);
+        _mm_store_si128(reinterpret_cast<__m128i*>(minutes + 8 * j), m);
+    }
+    if (_mm_movemask_epi8(inRange) != 0xffff)
+        return false;
+
+    for (int k = 0; k < 8; ++k)
+        out.emplace_back(hours[3 * k], minutes[3 * k + 1]);
+    return true;
+}
+
+#endif
+
+char* writeTwoDigits(char* p, int value) {
+    *p++ = static_cast<char>('0' + value / 10);
+    *p++ = static_cast<char>('0' + value % 10);
+    return p;
+}
+
+}
+
+std::size_t parseTimes(std::string_view text, std::vector<Time>& out, char separator) {
+    out.reserve(out.size() + text.size() / recordSize + 1);
+    std::size_t position = 0;
+
+#ifdef __SSE2__
+    const ChunkPatterns patterns = makePatterns(separator);
+    while (text.size() - position >= 8 * recordSize) {
+        if (!parseChunk(text.data() + position, patterns, out))
+            break;
+        position += 8 * recordSize;
+    }
+#endif
+
+    // The tail, and everything after a chunk that is not 8 well-formed records
+    while (position < text.size() && parseRecord(text, position, out, separator))
+        ;
+    return position;
+}
+
+std::size_t formatTimes(const Time* times, std::size_t count, char* buffer, std::size_t capacity,
+                        char separator) {
+    char* p = buffer;
+    char* end = buffer + capacity;
+    for (std::size_t i = 0; i < count; ++i) {
+        int hours = times[i].getHours();
+        int minutes = times[i].getMinutes();
+
+        // parseTimes could not read it back
+        if (hours < 0 || minutes < 0 || minutes > 59)
+            break;
+
+        if (hours < 100) {
+            if (end - p < static_cast<std::ptrdiff_t>(recordSize))
+                break;
+            p = writeTwoDigits(p, hours);
+            *p++ = ':';
+            p = writeTwoDigits(p, minutes);
+            *p++ = separator;
+            continue;
+        }
+
+        // Rare case: long hours, converted by std::to_chars
+        char hoursText[16];
+        char* hoursEnd = std::to_chars(hoursText, hoursText + sizeof(hoursText), hours).ptr;
+
+        std::ptrdiff_t length = (hoursEnd - hoursText) + 4;
+        if (end - p < length)
+            break;
+        p = std::copy(hoursText, hoursEnd, p);
+        *p++ = ':';
+        p = writeTwoDigits(p, minutes);
+        *p++ = separator;
+    }
+    return static_cast<std::size_t>(p - buffer);
+}
@@ -0,0 +1,29 @@
+#ifndef TIME_IO_HPP
+#define TIME_IO_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "time.hpp"
+
+// Bulk text input and output of Time.
+//
+// Time is a duration, so hours are not limited to 23. Both functions use the same text:
+// hours as at least two digits (without extra leading zeros), ':', minutes 00-59, so whatever
+// formatTimes writes, parseTimes reads back unchanged.
+//
+// parseTimes reads such records followed by the separator (the last record may end without it)
+// and appends them to out. Parsing stops at the first malformed record; the return value is
+// the number of characters consumed, so a fully valid text returns text.size().
+// With SSE2, 8 records "HH:MM" (48 bytes) are validated and converted at once.
+//
+// formatTimes writes times plus the separator into buffer and returns the number of characters
+// written. It stops before a record that does not fit, and before a time that parseTimes could not
+// read (negative hours or minutes outside 00-59). 6 * count bytes are enough for hours below 100.
+
+std::size_t parseTimes(std::string_view text, std::vector<Time>& out, char separator = '\n');
+std::size_t formatTimes(const Time* times, std::size_t count, char* buffer, std::size_t capacity,
+                        char separator = '\n');
+
+#endif // TIME_IO_HPP